@@ -0,0 +1,164 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2017 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Replays a capture through one incremental head parser per stream and reports the throughput.  Bodies are skipped
+// using Content-Length.
+//
+// http_capture_replay_bench <capture> [original|fixed|random] [chunk_size] [passes]
+// http_capture_replay_bench --write <capture> [requests]   writes a synthetic capture to start from
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <unordered_map>
+
+#include "http_async_parser.h"
+#include "http_capture.h"
+
+namespace {
+	struct stream_state {
+		std::string buffer;
+		daw::http::http_request_head_parser parser;
+		uint64_t body_left;
+
+		stream_state( ) : buffer{}, parser{}, body_left{0} {
+			// the parser needs the bytes to stay at the same address, a head is never larger than this
+			buffer.reserve( 64 * 1024 );
+		}
+	};
+
+	struct replay_totals {
+		uint64_t requests;
+		uint64_t bytes;
+		uint64_t chunks;
+	};
+
+	void consume_body( stream_state &stream ) {
+		auto const count = stream.body_left < stream.buffer.size( ) ? stream.body_left : stream.buffer.size( );
+		stream.buffer.erase( 0, count );
+		stream.body_left -= count;
+	}
+
+	replay_totals replay_once( daw::http::http_capture_reader const &capture,
+	                           daw::http::http_replay_policy const &policy ) {
+		std::unordered_map<uint32_t, stream_state> streams{};
+		replay_totals totals{0, 0, 0};
+		daw::http::replay( capture, policy, [&]( daw::http::http_capture_record const &record, daw::string_view chunk ) {
+			auto &stream = streams[record.stream];
+			++totals.chunks;
+			totals.bytes += chunk.size( );
+			if( stream.body_left >= chunk.size( ) ) {
+				stream.body_left -= chunk.size( );
+				return;
+			}
+			chunk.remove_prefix( stream.body_left );
+			stream.body_left = 0;
+			stream.buffer.append( chunk.data( ), chunk.size( ) );
+			while( auto const head_size = stream.parser.parse( stream.buffer ) ) {
+				++totals.requests;
+				auto const length = stream.parser.headers( )[daw::http::known_header::content_length];
+				stream.body_left =
+				  length.empty( ) ? 0 : daw::http::parse_to_value( length, daw::http::http_content_length{} );
+				stream.buffer.erase( 0, head_size );
+				stream.parser.reset( );
+				consume_body( stream );
+			}
+		} );
+		return totals;
+	}
+
+	int write_synthetic( char const *path, size_t const requests ) {
+		daw::http::http_capture_writer writer{path};
+		std::string const body = "{\"id\":1,\"name\":\"value\"}";
+		for( size_t n = 0; n < requests; ++n ) {
+			bool const is_post = n % 4 == 3;
+			std::string req =
+			  is_post ? "POST /api/items HTTP/1.1\r\n" : "GET /static/" + std::to_string( n ) + ".js HTTP/1.1\r\n";
+			req += "Host: example.com\r\nUser-Agent: Mozilla/5.0 (X11; Linux x86_64)\r\n";
+			req += "Accept: */*\r\nAccept-Encoding: gzip, deflate, br\r\nConnection: keep-alive\r\n";
+			if( is_post ) {
+				req += "Content-Type: application/json\r\nContent-Length: " + std::to_string( body.size( ) ) + "\r\n\r\n";
+				req += body;
+			} else {
+				req += "\r\n";
+			}
+			// 16 connections, each read split in two like a short read from the socket
+			auto const stream = static_cast<uint32_t>( n % 16 );
+			auto const split = req.size( ) / 3;
+			writer.write( stream, daw::string_view{req}.substr( 0, split ) );
+			writer.write( stream, daw::string_view{req}.substr( split ) );
+		}
+		return EXIT_SUCCESS;
+	}
+} // namespace
+
+int main( int argc, char **argv ) {
+	if( argc < 2 ) {
+		std::fprintf( stderr, "%s <capture> [original|fixed|random] [chunk_size] [passes]\n"
+		                      "%s --write <capture> [requests]\n",
+		              argv[0], argv[0] );
+		return EXIT_FAILURE;
+	}
+	if( std::strcmp( argv[1], "--write" ) == 0 ) {
+		if( argc < 3 ) {
+			return EXIT_FAILURE;
+		}
+		return write_synthetic( argv[2], argc > 3 ? std::strtoul( argv[3], nullptr, 10 ) : 100000 );
+	}
+
+	daw::http::http_replay_policy policy{};
+	if( argc > 2 ) {
+		if( std::strcmp( argv[2], "fixed" ) == 0 ) {
+			policy.chunking = daw::http::http_replay_chunking::fixed;
+		} else if( std::strcmp( argv[2], "random" ) == 0 ) {
+			policy.chunking = daw::http::http_replay_chunking::random;
+		}
+	}
+	policy.chunk_size = argc > 3 ? std::strtoul( argv[3], nullptr, 10 ) : 64;
+	size_t passes = argc > 4 ? std::strtoul( argv[4], nullptr, 10 ) : 10;
+	if( passes == 0 ) {
+		passes = 1;
+	}
+
+	daw::http::http_capture_reader const capture{argv[1]};
+	// first pass pages the capture in
+	replay_once( capture, policy );
+	replay_totals totals{0, 0, 0};
+	auto const start = std::chrono::steady_clock::now( );
+	for( size_t pass = 0; pass < passes; ++pass ) {
+		auto const result = replay_once( capture, policy );
+		totals.requests += result.requests;
+		totals.bytes += result.bytes;
+		totals.chunks += result.chunks;
+	}
+	std::chrono::duration<double> const elapsed = std::chrono::steady_clock::now( ) - start;
+	double const seconds = elapsed.count( );
+	std::printf( "%llu requests in %llu chunks, %.0f requests/s, %.1f MB/s\n",
+	             static_cast<unsigned long long>( totals.requests / passes ),
+	             static_cast<unsigned long long>( totals.chunks / passes ),
+	             static_cast<double>( totals.requests ) / seconds,
+	             static_cast<double>( totals.bytes ) / seconds / ( 1024.0 * 1024.0 ) );
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,92 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2017 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Time of parse_headers against http_header_cache::parse_headers on the same header block, as a keep-alive client
+// sends it: unchanged, and with one line changed per request.
+//
+// http_header_cache_bench [iterations]
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+#include "http_header_cache.h"
+#include "http_headers.h"
+
+namespace {
+	// About 1KB, like a browser's headers
+	std::string make_block( size_t const request_id ) {
+		std::string result = "Host: www.example.com\r\n";
+		result += "User-Agent: Mozilla/5.0 (X11; Linux x86_64) AppleWebKit/537.36 (KHTML, like Gecko) "
+		          "Chrome/120.0.0.0 Safari/537.36\r\n";
+		result += "Accept: text/html,application/xhtml+xml,application/xml;q=0.9,image/avif,image/webp,*/*;q=0.8\r\n";
+		result += "Accept-Encoding: gzip, deflate, br\r\n";
+		result += "Accept-Language: en-US,en;q=0.9,fr;q=0.8\r\n";
+		result += "Cache-Control: max-age=0\r\n";
+		result += "Cookie: session=" + std::string( 64, 's' ) + "; prefs=" + std::string( 200, 'p' ) + "\r\n";
+		result += "Referer: https://www.example.com/catalog/items?page=3&sort=price\r\n";
+		result += "Sec-Fetch-Dest: document\r\nSec-Fetch-Mode: navigate\r\nSec-Fetch-Site: same-origin\r\n";
+		result += "Upgrade-Insecure-Requests: 1\r\n";
+		result += "X-Request-Id: " + std::to_string( 1000000 + request_id ) + "\r\n";
+		result += "Connection: keep-alive\r\n\r\n";
+		return result;
+	}
+
+	template<typename Parse>
+	double ns_per_block( std::string const *blocks, size_t const iterations, uint64_t &checksum, Parse parse ) {
+		daw::http::http_header_index headers{};
+		auto const start = std::chrono::steady_clock::now( );
+		for( size_t n = 0; n < iterations; ++n ) {
+			checksum += parse( blocks[n % 2], headers );
+			checksum += headers.size( );
+		}
+		std::chrono::duration<double, std::nano> const elapsed = std::chrono::steady_clock::now( ) - start;
+		return elapsed.count( ) / static_cast<double>( iterations );
+	}
+} // namespace
+
+int main( int argc, char **argv ) {
+	size_t const iterations = argc > 1 ? std::strtoul( argv[1], nullptr, 10 ) : 1000000;
+	// the request id line alternates in the changed case, the other lines repeat
+	std::string const unchanged[] = {make_block( 0 ), make_block( 0 )};
+	std::string const changed[] = {make_block( 0 ), make_block( 1 )};
+
+	uint64_t checksum = 0;
+	std::printf( "%-10s %8s %14s %14s %10s\n", "block", "bytes", "parse ns", "cached ns", "speedup" );
+	for( auto const blocks : {unchanged, changed} ) {
+		auto const plain = ns_per_block( blocks, iterations, checksum,
+		                                 []( daw::string_view const str, daw::http::http_header_index &headers ) {
+			                                 return daw::http::parse_headers( str, headers );
+		                                 } );
+		daw::http::http_header_cache cache{};
+		auto const cached = ns_per_block( blocks, iterations, checksum,
+		                                  [&cache]( daw::string_view const str, daw::http::http_header_index &headers ) {
+			                                  return cache.parse_headers( str, headers );
+		                                  } );
+		std::printf( "%-10s %8zu %14.1f %14.1f %9.2fx\n", blocks == unchanged ? "unchanged" : "one line",
+		             blocks[0].size( ), plain, cached, plain / cached );
+	}
+	std::printf( "(checksum %016llx)\n", static_cast<unsigned long long>( checksum ) );
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,165 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2017 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Parses the same corpus on 1 to N threads, each with its own http_parser_context, and reports the throughput and
+// how close it is to linear.  Every thread does the same amount of work, so anything shared on the parse path shows
+// up as efficiency falling with the thread count.
+//
+// http_parse_scaling_bench [max_threads] [passes] [min_efficiency]
+// Exits with 1 when the efficiency at any thread count is below min_efficiency( 0.0 - 1.0, default 0 )
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "http_fingerprint.h"
+#include "http_parser_context.h"
+
+namespace {
+	std::vector<std::string> make_corpus( ) {
+		std::vector<std::string> const targets = {
+		  "/",
+		  "/index.html",
+		  "/api/v1/users/12345/orders?page=2&per_page=50&sort=-created",
+		  "/static/js/app.3f2a9c.min.js",
+		  "/search?q=caf%C3%A9+au+lait&lang=fr",
+		  "/images/%E6%97%A5%E6%9C%AC/photo%201.jpg",
+		  "http://example.com:8080/proxy/path?x=1#frag",
+		  "/a/b/c/d/e/f/g/h/i/j/k/l/m/n/o/p?aa=1&bb=2&cc=3&dd=4"};
+		std::vector<std::string> const methods = {"GET", "POST", "HEAD", "PUT", "DELETE", "OPTIONS"};
+		std::vector<std::string> result{};
+		for( size_t n = 0; n < 64; ++n ) {
+			std::string req = methods[n % methods.size( )] + " " + targets[n % targets.size( )] + " HTTP/1.1\r\n";
+			req += "Host: www" + std::to_string( n % 5 ) + ".example.com\r\n";
+			req += "User-Agent: Mozilla/5.0 (X11; Linux x86_64) AppleWebKit/537.36 (KHTML, like Gecko)\r\n";
+			req += "Accept: text/html,application/xhtml+xml,application/xml;q=0.9,*/*;q=0.8\r\n";
+			req += "Accept-Encoding: gzip, deflate, br\r\n";
+			req += "Accept-Language: en-US,en;q=0.5\r\n";
+			if( n % 3 == 0 ) {
+				req += "Cookie: session=" + std::string( 32, static_cast<char>( 'a' + n % 26 ) ) + "; theme=dark\r\n";
+			}
+			if( n % 4 == 1 ) {
+				req += "Content-Type: application/json\r\nContent-Length: 0\r\n";
+			}
+			req += "X-Request-Id: " + std::to_string( 1000000 + n ) + "\r\n";
+			req += "Connection: keep-alive\r\n\r\n";
+			result.push_back( std::move( req ) );
+		}
+		return result;
+	}
+
+	struct thread_result {
+		uint64_t requests;
+		uint64_t checksum;
+	};
+
+	thread_result parse_corpus( std::vector<std::string> const &corpus, size_t const passes ) {
+		daw::http::http_parser_context context{};
+		uint64_t checksum = 0;
+		for( size_t pass = 0; pass < passes; ++pass ) {
+			for( auto const &req : corpus ) {
+				checksum += context.parse( req );
+				checksum ^= daw::http::request_fingerprint( context.request, context.headers );
+				checksum += context.decoded_path( ).size( );
+			}
+		}
+		return thread_result{context.counters.requests, checksum};
+	}
+
+	struct run_result {
+		double seconds;
+		uint64_t requests;
+		uint64_t checksum;
+	};
+
+	run_result run( std::vector<std::string> const &corpus, size_t const thread_count, size_t const passes ) {
+		std::vector<thread_result> results( thread_count );
+		std::vector<std::thread> threads{};
+		std::atomic<size_t> ready{0};
+		std::atomic<bool> go{false};
+		for( size_t n = 0; n < thread_count; ++n ) {
+			threads.emplace_back( [&, n]( ) {
+				ready.fetch_add( 1 );
+				while( !go.load( std::memory_order_acquire ) ) {
+					std::this_thread::yield( );
+				}
+				results[n] = parse_corpus( corpus, passes );
+			} );
+		}
+		while( ready.load( ) != thread_count ) {
+			std::this_thread::yield( );
+		}
+		auto const start = std::chrono::steady_clock::now( );
+		go.store( true, std::memory_order_release );
+		for( auto &thread : threads ) {
+			thread.join( );
+		}
+		std::chrono::duration<double> const elapsed = std::chrono::steady_clock::now( ) - start;
+
+		run_result result{elapsed.count( ), 0, 0};
+		for( auto const &r : results ) {
+			result.requests += r.requests;
+			result.checksum += r.checksum;
+		}
+		return result;
+	}
+} // namespace
+
+int main( int argc, char **argv ) {
+	size_t max_threads = std::thread::hardware_concurrency( );
+	if( argc > 1 ) {
+		max_threads = std::strtoul( argv[1], nullptr, 10 );
+	}
+	if( max_threads == 0 ) {
+		max_threads = 1;
+	}
+	size_t const passes = argc > 2 ? std::strtoul( argv[2], nullptr, 10 ) : 20000;
+	double const min_efficiency = argc > 3 ? std::strtod( argv[3], nullptr ) : 0.0;
+
+	auto const corpus = make_corpus( );
+	// warm up caches and the page tables of the corpus
+	run( corpus, 1, passes / 10 + 1 );
+
+	std::printf( "%8s %14s %12s %10s\n", "threads", "requests/s", "speedup", "efficiency" );
+	double single_rate = 0.0;
+	bool passed = true;
+	for( size_t thread_count = 1; thread_count <= max_threads; ++thread_count ) {
+		auto const result = run( corpus, thread_count, passes );
+		double const rate = static_cast<double>( result.requests ) / result.seconds;
+		if( thread_count == 1 ) {
+			single_rate = rate;
+		}
+		double const speedup = rate / single_rate;
+		double const efficiency = speedup / static_cast<double>( thread_count );
+		std::printf( "%8zu %14.0f %12.2f %9.1f%% (checksum %016llx)\n", thread_count, rate, speedup,
+		             efficiency * 100.0, static_cast<unsigned long long>( result.checksum ) );
+		if( efficiency < min_efficiency ) {
+			passed = false;
+		}
+	}
+	return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -28,7 +28,7 @@
 #include <daw/daw_traits.h>
 #include <daw/daw_utility.h>
 
-#define CONSTEXPR
+#define CONSTEXPR constexpr
 
 namespace daw {
 	namespace parsing {
@@ -44,13 +44,13 @@ namespace daw {
 
 		template<typename Range>
 		constexpr test_result check_str( daw::string_view str ) noexcept( noexcept( Range::check( char{} ) ) ) {
-			test_result result{0, 0, ( !str.empty( ) || Range::check( str[0] ) )};
+			test_result result{0, 0, ( !str.empty( ) && Range::check( str[0] ) )};
 			if( !result ) {
 				return result;
 			}
 			for( size_t n = 1; n < str.size( ); ++n ) {
 				if( !Range::check( str[n] ) ) {
-					result.last = n - 1;
+					result.last = n;
 					return result;
 				}
 			}
@@ -70,14 +70,15 @@ namespace daw {
 			}
 		};
 
-		// Specific character - true if c is equal to item
+		// Specific character - true if c is equal to item.  Only a single character is consumed
 		template<char item>
 		struct chr {
 			static CONSTEXPR bool check( char const c ) noexcept {
 				return c == item;
 			}
 			static CONSTEXPR test_result check( daw::string_view const str ) noexcept {
-				return check_str<chr>( str );
+				bool const found = !str.empty( ) && check( str.front( ) );
+				return test_result{0, found ? 1U : 0U, found};
 			}
 		};
 		namespace impl {
@@ -191,7 +192,7 @@ namespace daw {
 					result.found = true;
 					result.last += result2.last;
 					str.remove_prefix( result2.last );
-					if( n < N && str.empty( ) ) {
+					if( n + 1 < N && str.empty( ) ) {
 						return {0, 0, false};
 					}
 				}
@@ -239,6 +240,9 @@ namespace daw {
 				auto result = Range::check( str );
 				if( result ) {
 					auto result2 = sequence<Ranges...>::check( str.substr( result.last ) );
+					if( !result2 ) {
+						return result2;
+					}
 					result.last += result2.last;
 				}
 				return result;
@@ -260,18 +264,18 @@ namespace daw {
 			}
 		};
 
-		// Will consume zero or more ranges, this is like kleene star
+		// Will consume zero or more ranges, this is like kleene star.  Matching nothing is still found
 		template<typename Range>
 		struct zero_or_more {
 			static CONSTEXPR test_result check( daw::string_view str ) noexcept {
 				auto result = Range::check( str );
 				if( !result || result.last == 0 ) {
-					return result;
+					return test_result{0, 0, true};
 				}
 				str.remove_prefix( result.last );
 				while( !str.empty( ) ) {
 					auto result2 = Range::check( str );
-					if( !result2 || result2.last = 0 ) {
+					if( !result2 || result2.last == 0 ) {
 						return result;
 					}
 					result.last += result2.last;
@@ -0,0 +1,183 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2017 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+#include <daw/daw_parser_helper.h>
+#include <daw/daw_string_view.h>
+
+// SIMD within a register helpers.  Eight characters are processed at once in a uint64_t where
+// character n of the input always lives in byte n( bits 8n to 8n+7 ) regardless of the platform endianess.
+// Everything is constexpr, the byte by byte loads are folded into a single unaligned load by the optimizer
+namespace daw {
+	namespace swar {
+		constexpr uint64_t const lo_bits = 0x0101'0101'0101'0101ULL;
+		constexpr uint64_t const hi_bits = 0x8080'8080'8080'8080ULL;
+
+		constexpr uint64_t broadcast( uint8_t const b ) noexcept {
+			return lo_bits * b;
+		}
+
+		// All bits of the first count bytes
+		constexpr uint64_t prefix_mask( size_t const count ) noexcept {
+			return count >= 8 ? ~0ULL : ( ( 1ULL << ( 8 * count ) ) - 1 );
+		}
+
+		// Load up to 8 characters from ptr.  Missing bytes are filled with fill
+		constexpr uint64_t load( char const *ptr, size_t const count, uint8_t const fill = 0 ) noexcept {
+			uint64_t result = 0;
+			size_t n = 0;
+			for( ; n < count && n < 8; ++n ) {
+				result |= static_cast<uint64_t>( static_cast<uint8_t>( ptr[n] ) ) << ( 8 * n );
+			}
+			for( ; n < 8; ++n ) {
+				result |= static_cast<uint64_t>( fill ) << ( 8 * n );
+			}
+			return result;
+		}
+
+		constexpr uint64_t load( daw::string_view const str, uint8_t const fill = 0 ) noexcept {
+			return load( str.data( ), str.size( ), fill );
+		}
+
+		// The high bit of each byte of the result is set when that byte is within [lo, hi]. 0 < lo <= hi < 127
+		constexpr uint64_t bytes_between( uint64_t const x, uint8_t const lo, uint8_t const hi ) noexcept {
+			uint64_t const low7 = x & ( lo_bits * 127U );
+			return ( lo_bits * ( 128U + hi ) - low7 ) & ~x & ( low7 + lo_bits * ( 128U - lo ) ) & hi_bits;
+		}
+
+		constexpr uint64_t bytes_equal( uint64_t const x, uint8_t const c ) noexcept {
+			return bytes_between( x, c, c );
+		}
+
+		constexpr uint64_t digits( uint64_t const x ) noexcept {
+			return bytes_between( x, '0', '9' );
+		}
+
+		// Index of the first byte whose high bit is set in mask, 8 when there is none
+		constexpr size_t first_set_byte( uint64_t const mask ) noexcept {
+			if( mask == 0 ) {
+				return 8;
+			}
+#if defined( __GNUC__ ) || defined( __clang__ )
+			return static_cast<size_t>( __builtin_ctzll( mask ) ) / 8;
+#else
+			size_t n = 0;
+			while( ( mask & ( 0x80ULL << ( 8 * n ) ) ) == 0 ) {
+				++n;
+			}
+			return n;
+#endif
+		}
+
+		// Number of bytes whose high bit is set in mask
+		constexpr size_t count_set_bytes( uint64_t const mask ) noexcept {
+#if defined( __GNUC__ ) || defined( __clang__ )
+			return static_cast<size_t>( __builtin_popcountll( mask & hi_bits ) );
+#else
+			return static_cast<size_t>( ( ( ( mask & hi_bits ) >> 7 ) * lo_bits ) >> 56 );
+#endif
+		}
+
+		// Number of leading characters that are in the mask
+		constexpr size_t leading_set_bytes( uint64_t const mask ) noexcept {
+			return first_set_byte( ~mask & hi_bits );
+		}
+
+		// Position of the first c in str at or after pos, npos if there is none.  c must be 7bit ASCII other than
+		// NUL.  8 characters per step
+		constexpr size_t find( daw::string_view const str, char const c, size_t pos = 0 ) noexcept {
+			while( pos < str.size( ) ) {
+				size_t const count = str.size( ) - pos;
+				uint64_t const word = load( str.data( ) + pos, count );
+				size_t const idx = first_set_byte( bytes_equal( word, static_cast<uint8_t>( c ) ) );
+				if( idx < 8 ) {
+					return idx < count ? pos + idx : daw::string_view::npos;
+				}
+				pos += 8;
+			}
+			return daw::string_view::npos;
+		}
+
+		// Value of 8 decimal digits, most significant in byte 0.  Lanes may hold '0'-'9' or 0
+		constexpr uint32_t parse_8_digits( uint64_t word ) noexcept {
+			word = ( ( word & broadcast( 0x0F ) ) * ( 10 * 256 + 1 ) ) >> 8;
+			word = ( ( word & 0x00FF'00FF'00FF'00FFULL ) * ( 100 * 65536 + 1 ) ) >> 16;
+			word = ( ( word & 0x0000'FFFF'0000'FFFFULL ) * ( 10000ULL * 4294967296ULL + 1 ) ) >> 32;
+			return static_cast<uint32_t>( word );
+		}
+
+		namespace impl {
+			// Value of the first count( 1-8 ) characters of str, throws if any are not digits
+			constexpr uint32_t parse_digit_chunk( daw::string_view const str, size_t const count ) {
+				uint64_t const word = load( str.data( ), count );
+				uint64_t const required = hi_bits & prefix_mask( count );
+				if( ( digits( word ) & required ) != required ) {
+					throw daw::parser::invalid_input_exception{};
+				}
+				// right align the digits, the vacated lanes are 0
+				return parse_8_digits( word << ( 8 * ( 8 - count ) ) );
+			}
+		} // namespace impl
+
+		// Widest decimal representation of Unsigned, 5 for uint16_t and 20 for uint64_t
+		template<typename Unsigned>
+		constexpr size_t max_digits( ) noexcept {
+			return static_cast<size_t>( std::numeric_limits<Unsigned>::digits10 ) + 1;
+		}
+
+		// Parse an unsigned decimal, 8 digits per step.  Like daw::parser::converters::helpers::parse_unsigned_int
+		// an input longer than max_digits is an overflow before its characters are looked at.  Non-digits are
+		// invalid input and values that do not fit in Unsigned overflow
+		template<typename Unsigned>
+		constexpr Unsigned parse_unsigned( daw::string_view str ) {
+			static_assert( std::is_unsigned<Unsigned>::value && sizeof( Unsigned ) <= sizeof( uint64_t ),
+			               "Only unsigned types up to 64bits are supported" );
+			if( str.empty( ) ) {
+				throw daw::parser::invalid_input_exception{};
+			}
+			if( str.size( ) > max_digits<Unsigned>( ) ) {
+				throw daw::parser::numeric_overflow_exception{};
+			}
+			size_t const first_chunk = ( ( str.size( ) - 1 ) % 8 ) + 1;
+			uint64_t result = impl::parse_digit_chunk( str, first_chunk );
+			str.remove_prefix( first_chunk );
+			while( !str.empty( ) ) {
+				uint64_t const chunk = impl::parse_digit_chunk( str, 8 );
+				if( result > ( std::numeric_limits<uint64_t>::max( ) - chunk ) / 100000000ULL ) {
+					throw daw::parser::numeric_overflow_exception{};
+				}
+				result = result * 100000000ULL + chunk;
+				str.remove_prefix( 8 );
+			}
+			if( result > std::numeric_limits<Unsigned>::max( ) ) {
+				throw daw::parser::numeric_overflow_exception{};
+			}
+			return static_cast<Unsigned>( result );
+		}
+	} // namespace swar
+} // namespace daw
@@ -0,0 +1,55 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2017 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstdint>
+
+#include "daw_swar.h"
+
+// Hexadecimal digits as used by percent escapes and IPv6 literals.  The encoder, the decoders and the address
+// parser all use these so they agree on what a hex digit is
+namespace daw {
+	namespace http {
+		namespace impl {
+			constexpr bool is_hex_digit( char const c ) noexcept {
+				return ( '0' <= c && c <= '9' ) || ( 'a' <= c && c <= 'f' ) || ( 'A' <= c && c <= 'F' );
+			}
+
+			// Only valid for characters already known to be hex digits
+			constexpr uint8_t hex_value( char const c ) noexcept {
+				return static_cast<uint8_t>( ( c & 0xF ) + 9 * ( ( c >> 6 ) & 1 ) );
+			}
+
+			// The high bit of each byte is set when that character is a hex digit
+			constexpr uint64_t hex_digits( uint64_t const x ) noexcept {
+				return daw::swar::digits( x ) | daw::swar::bytes_between( x, 'a', 'f' ) |
+				       daw::swar::bytes_between( x, 'A', 'F' );
+			}
+
+			// Upper case digit of a value < 16, as RFC 3986 recommends for percent escapes
+			constexpr char upper_hex_digit( uint8_t const value ) noexcept {
+				return static_cast<char>( value < 10 ? '0' + value : 'A' + ( value - 10 ) );
+			}
+		} // namespace impl
+	} // namespace http
+} // namespace daw
@@ -0,0 +1,331 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2017 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+
+#include <daw/daw_string_view.h>
+
+#include "daw_swar.h"
+#include "http_headers.h"
+
+namespace daw {
+	namespace http {
+		// One element of a comma separated list with weights, like Accept or Accept-Encoding.  q is the weight in
+		// thousandths, 1000 when it is not given.  params are the parameters other than q, still unparsed
+		struct http_weighted_item {
+			daw::string_view value;
+			daw::string_view params;
+			uint16_t q;
+
+			explicit constexpr operator bool( ) const noexcept {
+				return !value.empty( );
+			}
+		};
+
+		namespace impl {
+			constexpr uint16_t const invalid_qvalue = 0xFFFF;
+
+			constexpr uint16_t qvalue_digit( uint64_t const word, size_t const n ) noexcept {
+				return static_cast<uint16_t>( ( word >> ( 8 * n ) ) & 0x0FU );
+			}
+
+			// qvalue = ( "0" [ "." 0*3DIGIT ] ) / ( "1" [ "." 0*3"0" ] ) as thousandths, invalid_qvalue when malformed.
+			// Missing digits are filled with '0' so that every value is checked and read as the same 5 character word
+			constexpr uint16_t parse_qvalue( daw::string_view const str ) noexcept {
+				if( str.empty( ) || str.size( ) > 5 ) {
+					return invalid_qvalue;
+				}
+				uint64_t word = daw::swar::load( str.data( ), str.size( ), '0' );
+				if( str.size( ) == 1 ) {
+					word = ( word & ~( 0xFFULL << 8U ) ) | ( static_cast<uint64_t>( '.' ) << 8U );
+				}
+				uint64_t const digit_lanes = daw::swar::hi_bits & daw::swar::prefix_mask( 5 ) & ~( 0x80ULL << 8U );
+				if( ( daw::swar::digits( word ) & digit_lanes ) != digit_lanes || ( ( word >> 8U ) & 0xFFU ) != '.' ) {
+					return invalid_qvalue;
+				}
+				auto const result = static_cast<uint16_t>( qvalue_digit( word, 0 ) * 1000 + qvalue_digit( word, 2 ) * 100 +
+				                                           qvalue_digit( word, 3 ) * 10 + qvalue_digit( word, 4 ) );
+				return result <= 1000 ? result : invalid_qvalue;
+			}
+
+			// Position of the ',' ending the element at the front of str, commas in quoted parameter values do not
+			// count.  npos when it is the last element
+			constexpr size_t find_list_element_end( daw::string_view const str ) noexcept {
+				auto const comma = daw::swar::find( str, ',' );
+				auto const quote = daw::swar::find( str, '"' );
+				if( quote == daw::string_view::npos || ( comma != daw::string_view::npos && comma < quote ) ) {
+					return comma;
+				}
+				bool quoted = false;
+				for( size_t pos = quote; pos < str.size( ); ++pos ) {
+					if( quoted && str[pos] == '\\' ) {
+						++pos;
+					} else if( str[pos] == '"' ) {
+						quoted = !quoted;
+					} else if( !quoted && str[pos] == ',' ) {
+						return pos;
+					}
+				}
+				return daw::string_view::npos;
+			}
+
+			// Take the element at the front of str and move str past it.  Elements with a malformed q are returned
+			// empty
+			constexpr http_weighted_item take_weighted_item( daw::string_view &str ) noexcept {
+				auto const element_end = find_list_element_end( str );
+				auto element = str.substr( 0, element_end );
+				str.remove_prefix( element_end == daw::string_view::npos ? str.size( ) : element_end + 1 );
+
+				auto const value_end = daw::swar::find( element, ';' );
+				http_weighted_item result{trim_ows( element.substr( 0, value_end ) ), daw::string_view{}, 1000};
+				if( value_end == daw::string_view::npos ) {
+					return result;
+				}
+				element.remove_prefix( value_end + 1 );
+				result.params = trim_ows( element );
+				// q is the last parameter of a media range, anything after it are accept-ext
+				while( !element.empty( ) ) {
+					auto const param_end = daw::swar::find( element, ';' );
+					auto const param = trim_ows( element.substr( 0, param_end ) );
+					if( param.size( ) >= 2 && ( param[0] == 'q' || param[0] == 'Q' ) && param[1] == '=' ) {
+						auto const q = parse_qvalue( trim_ows( param.substr( 2 ) ) );
+						if( q == invalid_qvalue ) {
+							return http_weighted_item{};
+						}
+						result.q = q;
+						// keep the parameters before q, without the ';' in front of it
+						auto const q_offset = static_cast<size_t>( param.data( ) - result.params.data( ) );
+						result.params = trim_ows( result.params.substr( 0, q_offset ) );
+						if( !result.params.empty( ) && result.params.back( ) == ';' ) {
+							result.params.remove_suffix( );
+							result.params = trim_ows( result.params );
+						}
+						break;
+					}
+					element.remove_prefix( param_end == daw::string_view::npos ? element.size( ) : param_end + 1 );
+				}
+				return result;
+			}
+		} // namespace impl
+
+		// Forward iterator over the elements of a weighted list header value.  Empty and malformed elements are
+		// skipped
+		struct http_weighted_list_iterator {
+			using value_type = http_weighted_item;
+			using difference_type = std::ptrdiff_t;
+			using pointer = http_weighted_item const *;
+			using reference = http_weighted_item const &;
+			using iterator_category = std::forward_iterator_tag;
+
+		private:
+			daw::string_view m_rest;
+			http_weighted_item m_current;
+
+			constexpr void advance( ) noexcept {
+				m_current = http_weighted_item{};
+				while( !m_rest.empty( ) && !m_current ) {
+					m_current = impl::take_weighted_item( m_rest );
+				}
+			}
+
+		public:
+			constexpr http_weighted_list_iterator( ) noexcept : m_rest{}, m_current{} {}
+
+			explicit constexpr http_weighted_list_iterator( daw::string_view const header ) noexcept
+			  : m_rest{header}, m_current{} {
+				advance( );
+			}
+
+			constexpr reference operator*( ) const noexcept {
+				return m_current;
+			}
+
+			constexpr pointer operator->( ) const noexcept {
+				return &m_current;
+			}
+
+			constexpr http_weighted_list_iterator &operator++( ) noexcept {
+				advance( );
+				return *this;
+			}
+
+			constexpr http_weighted_list_iterator operator++( int ) noexcept {
+				http_weighted_list_iterator tmp{*this};
+				advance( );
+				return tmp;
+			}
+
+			// The end iterator is the only one without a current element
+			constexpr bool equal( http_weighted_list_iterator const &rhs ) const noexcept {
+				return m_current.value.data( ) == rhs.m_current.value.data( ) &&
+				       m_current.value.size( ) == rhs.m_current.value.size( );
+			}
+		};
+
+		constexpr bool operator==( http_weighted_list_iterator const &lhs,
+		                           http_weighted_list_iterator const &rhs ) noexcept {
+			return lhs.equal( rhs );
+		}
+
+		constexpr bool operator!=( http_weighted_list_iterator const &lhs,
+		                           http_weighted_list_iterator const &rhs ) noexcept {
+			return !lhs.equal( rhs );
+		}
+
+		struct http_weighted_list_view {
+			daw::string_view header;
+
+			constexpr http_weighted_list_iterator begin( ) const noexcept {
+				return http_weighted_list_iterator{header};
+			}
+
+			constexpr http_weighted_list_iterator end( ) const noexcept {
+				return http_weighted_list_iterator{};
+			}
+		};
+
+		constexpr http_weighted_list_view make_weighted_list_view( daw::string_view const header ) noexcept {
+			return http_weighted_list_view{header};
+		}
+
+		// How the elements of a list are compared to what the server offers
+		enum class http_list_kind : uint_fast8_t {
+			// Accept, type/subtype with type/* and */* wildcards
+			media_type,
+			// Accept-Charset, a token or *
+			token,
+			// Accept-Encoding, a token or *.  identity is acceptable unless it is excluded( RFC 9110 12.5.3 )
+			encoding,
+			// Accept-Language, a range matches a tag that it equals or is a prefix of up to a '-'
+			language
+		};
+
+		struct http_offer {
+			daw::string_view value;
+			// size of the type of a media type, the position of the '/'
+			size_t type_size;
+		};
+
+		// What the server can produce, in order of preference.  Built once, usually as a constexpr, with
+		// make_offer_list
+		template<size_t N>
+		struct http_offer_list {
+			http_list_kind kind;
+			http_offer offers[N];
+
+			static constexpr size_t size( ) noexcept {
+				return N;
+			}
+		};
+
+		template<typename... Offers>
+		constexpr http_offer_list<sizeof...( Offers )> make_offer_list( http_list_kind const kind,
+		                                                                Offers const &... offers ) noexcept {
+			return http_offer_list<sizeof...( Offers )>{
+			  kind, {http_offer{daw::string_view{offers}, daw::string_view{offers}.find( '/' )}...}};
+		}
+
+		namespace impl {
+			// How closely range matches offer, 0 when it does not.  More specific ranges take precedence
+			constexpr size_t match_specificity( http_list_kind const kind, http_offer const &offer,
+			                                    daw::string_view const range ) noexcept {
+				if( range.size( ) == 1 && range[0] == '*' ) {
+					return 1;
+				}
+				switch( kind ) {
+				case http_list_kind::media_type: {
+					if( range.size( ) == 3 && range[0] == '*' && range[1] == '/' && range[2] == '*' ) {
+						return 1;
+					}
+					auto const type_size = range.find( '/' );
+					if( type_size == daw::string_view::npos || type_size != offer.type_size ||
+					    !equal_ignore_case( range.substr( 0, type_size ), offer.value.substr( 0, type_size ) ) ) {
+						return 0;
+					}
+					if( range.size( ) == type_size + 2 && range[type_size + 1] == '*' ) {
+						return 2;
+					}
+					return range.size( ) == offer.value.size( ) && equal_ignore_case( range, offer.value ) ? 3 : 0;
+				}
+				case http_list_kind::token:
+				case http_list_kind::encoding:
+					return range.size( ) == offer.value.size( ) && equal_ignore_case( range, offer.value ) ? 2 : 0;
+				case http_list_kind::language:
+					if( range.size( ) > offer.value.size( ) ||
+					    ( range.size( ) < offer.value.size( ) && offer.value[range.size( )] != '-' ) ||
+					    !equal_ignore_case( range, offer.value.substr( 0, range.size( ) ) ) ) {
+						return 0;
+					}
+					return range.size( ) + 1;
+				}
+				return 0;
+			}
+
+			constexpr bool is_identity( http_offer const &offer ) noexcept {
+				return offer.value.size( ) == 8 && equal_ignore_case( offer.value, "identity" );
+			}
+		} // namespace impl
+
+		// Index of the offer the client prefers, npos when none is acceptable.  The header value is read once and
+		// each offer keeps the weight of the most specific range that matched it, so nothing is sorted or allocated.
+		// Ties go to the earlier offer.  An empty header accepts anything so the first offer is returned, except for
+		// http_list_kind::encoding where an empty Accept-Encoding means identity only.  A request without the header
+		// accepts any coding, so check headers.contains( known_header::accept_encoding ) before calling.  For encoding
+		// an identity offer that the header does not mention gets the lowest weight, it is chosen only when nothing
+		// that was asked for is offered
+		template<size_t N>
+		constexpr size_t negotiate( daw::string_view const header, http_offer_list<N> const &offers ) noexcept {
+			static_assert( N > 0, "At least one offer is required" );
+			bool const is_encoding = offers.kind == http_list_kind::encoding;
+			if( !is_encoding && impl::trim_ows( header ).empty( ) ) {
+				return 0;
+			}
+			size_t specificity[N] = {};
+			uint16_t q[N] = {};
+			if( is_encoding ) {
+				for( size_t n = 0; n < N; ++n ) {
+					q[n] = impl::is_identity( offers.offers[n] ) ? 1 : 0;
+				}
+			}
+			for( auto const &item : make_weighted_list_view( header ) ) {
+				for( size_t n = 0; n < N; ++n ) {
+					auto const s = impl::match_specificity( offers.kind, offers.offers[n], item.value );
+					if( s > specificity[n] ) {
+						specificity[n] = s;
+						q[n] = item.q;
+					}
+				}
+			}
+			size_t best = daw::string_view::npos;
+			for( size_t n = 0; n < N; ++n ) {
+				if( q[n] != 0 && ( best == daw::string_view::npos || q[n] > q[best] ) ) {
+					best = n;
+				}
+			}
+			return best;
+		}
+	} // namespace http
+} // namespace daw
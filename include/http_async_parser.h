@@ -0,0 +1,325 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2017 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+
+#include <daw/daw_parser_helper.h>
+#include <daw/daw_string_view.h>
+
+#include "http_headers.h"
+#include "http_limits.h"
+#include "http_req_parser.h"
+
+#if defined( __cpp_impl_coroutine ) && defined( __has_include )
+#if __has_include( <coroutine> )
+#include <coroutine>
+#define DAW_HTTP_HAS_COROUTINES
+#endif
+#endif
+
+namespace daw {
+	namespace http {
+		// Parses a request head that arrives in pieces.  Each call is given all of the bytes received so far, at the
+		// same address, and continues where the last call stopped, also inside the request line
+		struct http_request_head_parser {
+		private:
+			enum class state_t : uint_fast8_t { request_line, headers, done };
+
+			state_t m_state;
+			impl::request_line_scan m_line_scan;
+			size_t m_pos;
+			size_t m_headers_start;
+			http_limits m_limits;
+			http_request m_request;
+			http_header_index m_headers;
+
+		public:
+			explicit http_request_head_parser( http_limits const &limits = http_limits{} ) noexcept
+			  : m_state{state_t::request_line}
+			  , m_line_scan{0, 0, 0}
+			  , m_pos{0}
+			  , m_headers_start{0}
+			  , m_limits{limits}
+			  , m_request{}
+			  , m_headers{} {}
+
+			void reset( ) noexcept {
+				m_state = state_t::request_line;
+				m_line_scan = impl::request_line_scan{0, 0, 0};
+				m_pos = 0;
+				m_headers_start = 0;
+				m_headers.clear( );
+			}
+
+			bool done( ) const noexcept {
+				return m_state == state_t::done;
+			}
+
+			// Returns the size of the head once it is complete, 0 until then.  Throws on invalid input and
+			// http_limit_exceeded_exception when the head is larger than the limits
+			size_t parse( daw::string_view data ) {
+				if( m_state == state_t::request_line ) {
+					auto const line_end = impl::scan_request_line( data, m_limits, m_line_scan );
+					if( line_end == daw::string_view::npos ) {
+						return 0;
+					}
+					m_request = parse_request_line( data.substr( 0, line_end ) );
+					m_pos = line_end + 2;
+					m_headers_start = m_pos;
+					m_state = state_t::headers;
+				}
+				bool const truncated = data.size( ) - m_headers_start > m_limits.max_header_bytes;
+				if( truncated ) {
+					data = data.substr( 0, m_headers_start + m_limits.max_header_bytes );
+				}
+				while( m_state == state_t::headers ) {
+					if( data.size( ) - m_pos < 2 ) {
+						break;
+					}
+					if( data[m_pos] == '\r' ) {
+						if( data[m_pos + 1] != '\n' ) {
+							throw daw::parser::invalid_input_exception{};
+						}
+						m_pos += 2;
+						m_request.headers_present = m_headers.present( );
+						m_state = state_t::done;
+						break;
+					}
+					if( m_headers.size( ) >= max_header_count( m_limits ) ) {
+						throw http_limit_exceeded_exception{};
+					}
+					auto const line = parse_header_line( data.substr( m_pos ) );
+					if( line.size == 0 ) {
+						break;
+					}
+					m_headers.push_back( line.header );
+					m_pos += line.size;
+				}
+				if( m_state == state_t::done ) {
+					return m_pos;
+				}
+				if( truncated ) {
+					throw http_limit_exceeded_exception{};
+				}
+				return 0;
+			}
+
+			http_request const &request( ) const noexcept {
+				return m_request;
+			}
+
+			http_header_index const &headers( ) const noexcept {
+				return m_headers;
+			}
+		};
+
+#ifdef DAW_HTTP_HAS_COROUTINES
+		// co_await parser.next_request( source ) resumes with true once a request head has been parsed and false at the
+		// end of the stream.  Source needs
+		//   void async_read( char *buffer, size_t capacity, Callback on_read )
+		// where on_read( size_t count ) is called once, with 0 for end of stream, either before async_read returns
+		// or later from the same thread.  The bytes live in a fixed buffer inside the parser and the awaiter lives in
+		// the awaiting coroutine's frame, so waiting for a request allocates nothing.  The request and headers stay
+		// valid until the next call to next_request.  A request with a body must be followed by skip_body before the
+		// next call, otherwise the body is read as the next request
+		template<size_t BufferSize = 16 * 1024>
+		struct basic_async_http_request_parser {
+		private:
+			char m_buffer[BufferSize];
+			size_t m_size;
+			size_t m_head_size;
+			uint64_t m_skip;
+			http_request_head_parser m_parser;
+
+			daw::string_view data( ) const noexcept {
+				return daw::string_view{m_buffer, m_size};
+			}
+
+			// Drop the first count bytes and move what followed them to the front
+			void drop( size_t const count ) noexcept {
+				if( count != 0 ) {
+					std::memmove( m_buffer, m_buffer + count, m_size - count );
+					m_size -= count;
+				}
+			}
+
+			// Drop as much of a skipped body as has been received.  true when none of it is left
+			bool drop_skipped( ) noexcept {
+				size_t const count = m_skip < m_size ? static_cast<size_t>( m_skip ) : m_size;
+				drop( count );
+				m_skip -= count;
+				return m_skip == 0;
+			}
+
+			// Drop the previous request head and whatever of its body was skipped
+			void begin_next( ) noexcept {
+				if( m_head_size != 0 ) {
+					drop( m_head_size );
+					m_head_size = 0;
+					m_parser.reset( );
+				}
+				drop_skipped( );
+			}
+
+			bool try_parse( ) {
+				m_head_size = m_parser.parse( data( ) );
+				return m_head_size != 0;
+			}
+
+		public:
+			explicit basic_async_http_request_parser( http_limits const &limits = http_limits{} ) noexcept
+			  : m_buffer{}, m_size{0}, m_head_size{0}, m_skip{0}, m_parser{limits} {}
+
+			basic_async_http_request_parser( basic_async_http_request_parser const & ) = delete;
+			basic_async_http_request_parser &operator=( basic_async_http_request_parser const & ) = delete;
+
+			template<typename Source>
+			struct next_request_awaiter {
+			private:
+				basic_async_http_request_parser &m_self;
+				Source &m_source;
+				std::coroutine_handle<> m_handle;
+				std::exception_ptr m_error;
+				bool m_found;
+				bool m_done;
+				bool m_pending;
+				bool m_inline;
+
+				void finish( bool const found ) noexcept {
+					m_found = found;
+					m_done = true;
+				}
+
+				void on_read( size_t const count ) noexcept {
+					m_pending = false;
+					if( count == 0 ) {
+						finish( false );
+					} else {
+						m_self.m_size += count;
+						try {
+							if( m_self.drop_skipped( ) && m_self.try_parse( ) ) {
+								finish( true );
+							} else if( m_self.m_size == BufferSize ) {
+								throw daw::parser::invalid_input_exception{};
+							}
+						} catch( ... ) {
+							m_error = std::current_exception( );
+							finish( false );
+						}
+					}
+					if( m_inline ) {
+						return;
+					}
+					if( m_done || pump( ) ) {
+						m_handle.resume( );
+					}
+				}
+
+				// Issue reads until one completes later or the request is done.  true when done without suspending
+				bool pump( ) {
+					while( true ) {
+						m_pending = true;
+						m_inline = true;
+						m_source.async_read( m_self.m_buffer + m_self.m_size, BufferSize - m_self.m_size,
+						                     [this]( size_t const count ) { on_read( count ); } );
+						m_inline = false;
+						if( m_pending ) {
+							return false;
+						}
+						if( m_done ) {
+							return true;
+						}
+					}
+				}
+
+			public:
+				next_request_awaiter( basic_async_http_request_parser &self, Source &source ) noexcept
+				  : m_self{self}
+				  , m_source{source}
+				  , m_handle{}
+				  , m_error{}
+				  , m_found{false}
+				  , m_done{false}
+				  , m_pending{false}
+				  , m_inline{false} {}
+
+				bool await_ready( ) {
+					m_self.begin_next( );
+					try {
+						if( m_self.m_skip == 0 && m_self.try_parse( ) ) {
+							finish( true );
+						}
+					} catch( ... ) {
+						m_error = std::current_exception( );
+						finish( false );
+					}
+					return m_done;
+				}
+
+				bool await_suspend( std::coroutine_handle<> handle ) {
+					m_handle = handle;
+					return !pump( );
+				}
+
+				bool await_resume( ) {
+					if( m_error ) {
+						std::rethrow_exception( m_error );
+					}
+					return m_found;
+				}
+			};
+
+			template<typename Source>
+			next_request_awaiter<Source> next_request( Source &source ) noexcept {
+				return next_request_awaiter<Source>{*this, source};
+			}
+
+			http_request const &request( ) const noexcept {
+				return m_parser.request( );
+			}
+
+			http_header_index const &headers( ) const noexcept {
+				return m_parser.headers( );
+			}
+
+			// Bytes received after the current request head, e.g. the start of its body
+			daw::string_view remaining( ) const noexcept {
+				return data( ).substr( m_head_size );
+			}
+
+			// Mark the size bytes after the current head, its body, as used.  The part that is in remaining( ) is dropped
+			// by the next call to next_request, the rest is read and discarded by it before the next head is parsed, so
+			// a body can be larger than the buffer
+			void skip_body( uint64_t const size ) noexcept {
+				m_skip = size;
+			}
+		};
+
+		using async_http_request_parser = basic_async_http_request_parser<>;
+#endif
+	} // namespace http
+} // namespace daw
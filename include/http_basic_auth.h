@@ -0,0 +1,163 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2017 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <daw/daw_parser_helper.h>
+#include <daw/daw_string_view.h>
+
+#include "daw_swar.h"
+#include "http_headers.h"
+#include "http_req_parser.h"
+
+namespace daw {
+	namespace http {
+		namespace impl {
+			// Add the bytes of x and y lane by lane, carries do not cross into the next lane
+			constexpr uint64_t add_lanes( uint64_t const x, uint64_t const y ) noexcept {
+				uint64_t const low7 = daw::swar::lo_bits * 0x7FU;
+				return ( ( x & low7 ) + ( y & low7 ) ) ^ ( ( x ^ y ) & daw::swar::hi_bits );
+			}
+
+			// Every lane set to 0xFF where mask has its high bit set
+			constexpr uint64_t widen_mask( uint64_t const mask ) noexcept {
+				return ( ( mask & daw::swar::hi_bits ) >> 7 ) * 0xFFU;
+			}
+
+			// The 6bit values of 8 base64 characters, one per lane.  all_valid is cleared when any lane is not in the
+			// alphabet, '=' included
+			constexpr uint64_t base64_sextets( uint64_t const word, bool &all_valid ) noexcept {
+				uint64_t const upper = daw::swar::bytes_between( word, 'A', 'Z' );
+				uint64_t const lower = daw::swar::bytes_between( word, 'a', 'z' );
+				uint64_t const digit = daw::swar::digits( word );
+				uint64_t const plus = daw::swar::bytes_equal( word, '+' );
+				uint64_t const slash = daw::swar::bytes_equal( word, '/' );
+				all_valid = ( upper | lower | digit | plus | slash ) == daw::swar::hi_bits;
+				// 'A' -> 0, 'a' -> 26, '0' -> 52, '+' -> 62, '/' -> 63, all mod 256
+				uint64_t const offsets = ( widen_mask( upper ) & daw::swar::broadcast( 256 - 'A' ) ) |
+				                         ( widen_mask( lower ) & daw::swar::broadcast( 256 - 'a' + 26 ) ) |
+				                         ( widen_mask( digit ) & daw::swar::broadcast( 52 - '0' ) ) |
+				                         ( widen_mask( plus ) & daw::swar::broadcast( 62 - '+' ) ) |
+				                         ( widen_mask( slash ) & daw::swar::broadcast( 63 - '/' ) );
+				return add_lanes( word, offsets );
+			}
+
+			// Write the 6 octets held by 8 sextets
+			inline void base64_pack( uint64_t sextets, char *const out ) noexcept {
+				// 12 bits per 16bit lane, then 24 bits per 32bit lane, first character most significant
+				sextets = ( ( sextets & 0x00FF'00FF'00FF'00FFULL ) << 6 ) | ( ( sextets >> 8 ) & 0x00FF'00FF'00FF'00FFULL );
+				sextets = ( ( sextets & 0x0000'FFFF'0000'FFFFULL ) << 12 ) | ( ( sextets >> 16 ) & 0x0000'FFFF'0000'FFFFULL );
+				for( size_t half = 0; half < 2; ++half ) {
+					auto const bits = static_cast<uint32_t>( sextets >> ( 32 * half ) );
+					out[3 * half] = static_cast<char>( ( bits >> 16 ) & 0xFFU );
+					out[3 * half + 1] = static_cast<char>( ( bits >> 8 ) & 0xFFU );
+					out[3 * half + 2] = static_cast<char>( bits & 0xFFU );
+				}
+			}
+
+			constexpr uint32_t base64_value( char const c ) {
+				if( 'A' <= c && c <= 'Z' ) {
+					return static_cast<uint32_t>( c - 'A' );
+				}
+				if( 'a' <= c && c <= 'z' ) {
+					return static_cast<uint32_t>( c - 'a' + 26 );
+				}
+				if( '0' <= c && c <= '9' ) {
+					return static_cast<uint32_t>( c - '0' + 52 );
+				}
+				if( c == '+' ) {
+					return 62;
+				}
+				if( c == '/' ) {
+					return 63;
+				}
+				throw daw::parser::invalid_input_exception{};
+			}
+		} // namespace impl
+
+		// Room needed to decode encoded
+		constexpr size_t base64_decoded_size( daw::string_view const encoded ) noexcept {
+			return ( encoded.size( ) / 4 ) * 3;
+		}
+
+		// Decode padded base64( RFC 4648 section 4 ) into out, which needs base64_decoded_size( encoded ) characters.
+		// Returns the number of characters written.  Eight characters become six octets per step, the last quantum
+		// and its padding are done one character at a time.  Anything not in the alphabet, missing padding and
+		// padding bits that are not 0 throw
+		inline size_t base64_decode( daw::string_view encoded, char *const out ) {
+			if( encoded.size( ) % 4 != 0 ) {
+				throw daw::parser::invalid_input_exception{};
+			}
+			size_t out_pos = 0;
+			// the last quantum may hold padding and is never part of a word
+			while( encoded.size( ) > 8 ) {
+				bool all_valid = true;
+				auto const sextets = impl::base64_sextets( daw::swar::load( encoded.data( ), 8 ), all_valid );
+				if( !all_valid ) {
+					throw daw::parser::invalid_input_exception{};
+				}
+				impl::base64_pack( sextets, out + out_pos );
+				out_pos += 6;
+				encoded.remove_prefix( 8 );
+			}
+			while( !encoded.empty( ) ) {
+				size_t padding = 0;
+				if( encoded.size( ) == 4 ) {
+					padding = encoded[3] != '=' ? 0 : encoded[2] != '=' ? 1 : 2;
+				}
+				uint32_t bits = 0;
+				for( size_t n = 0; n < 4 - padding; ++n ) {
+					bits = ( bits << 6 ) | impl::base64_value( encoded[n] );
+				}
+				bits <<= 6 * padding;
+				if( ( bits & ( ( 1U << ( 8 * padding ) ) - 1 ) ) != 0 ) {
+					throw daw::parser::invalid_input_exception{};
+				}
+				for( size_t n = 0; n < 3 - padding; ++n ) {
+					out[out_pos++] = static_cast<char>( ( bits >> ( 16 - 8 * n ) ) & 0xFFU );
+				}
+				encoded.remove_prefix( 4 );
+			}
+			return out_pos;
+		}
+
+		// Credentials of an "Authorization: Basic <base64 of user-id:password>" value( RFC 7617 ), decoded into out
+		// which needs base64_decoded_size( value ) characters.  The views point into out.  The scheme name is case
+		// insensitive, a value with another scheme or without a ':' in the credentials throws
+		inline http_url_auth_info parse_basic_authorization( daw::string_view value, char *const out ) {
+			value = impl::trim_ows( value );
+			if( value.size( ) < 6 || !impl::equal_ignore_case( value.substr( 0, 6 ), "basic " ) ) {
+				throw daw::parser::invalid_input_exception{};
+			}
+			value = impl::trim_ows( value.substr( 6 ) );
+			daw::string_view const credentials{out, base64_decode( value, out )};
+			auto const colon = credentials.find( ':' );
+			if( colon == daw::string_view::npos ) {
+				throw daw::parser::invalid_input_exception{};
+			}
+			return http_url_auth_info{credentials.substr( 0, colon ), credentials.substr( colon + 1 )};
+		}
+	} // namespace http
+} // namespace daw
@@ -0,0 +1,361 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2017 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+// Binary capture of raw request bytes for replaying real traffic through the parser.  POSIX only, the reader maps
+// the file.
+//
+// All integers are little endian
+//   file header  "DAWHCAP" NUL, uint32 version( 1 ), uint32 flags( bit 0: records have timestamps )
+//   record       [uint64 nanoseconds since the capture started], uint32 stream, uint32 size, size octets
+// A stream is one connection, its records are its reads in order.  Records of different streams can interleave
+
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <daw/daw_parser_helper.h>
+#include <daw/daw_string_view.h>
+
+#include "http_system_error.h"
+
+namespace daw {
+	namespace http {
+		constexpr uint32_t const http_capture_version = 1;
+		constexpr uint32_t const http_capture_has_timestamps = 1;
+
+		struct http_capture_record {
+			uint64_t timestamp_ns; // 0 when the capture has no timestamps
+			uint32_t stream;
+			daw::string_view data;
+		};
+
+		namespace impl {
+			constexpr char const http_capture_magic[8] = {'D', 'A', 'W', 'H', 'C', 'A', 'P', '\0'};
+			constexpr size_t const http_capture_header_size = 16;
+
+			template<typename Unsigned>
+			void put_le( std::vector<char> &out, Unsigned value ) {
+				for( size_t n = 0; n < sizeof( Unsigned ); ++n ) {
+					out.push_back( static_cast<char>( value & 0xFFU ) );
+					value = static_cast<Unsigned>( value >> 8 );
+				}
+			}
+
+			template<typename Unsigned>
+			constexpr Unsigned get_le( char const *ptr ) noexcept {
+				Unsigned result = 0;
+				for( size_t n = sizeof( Unsigned ); n > 0; --n ) {
+					result = static_cast<Unsigned>( ( result << 8 ) | static_cast<uint8_t>( ptr[n - 1] ) );
+				}
+				return result;
+			}
+		} // namespace impl
+
+		// Writes a capture file.  Records are buffered and written in large blocks
+		struct http_capture_writer {
+		private:
+			int m_fd;
+			bool m_timestamps;
+			std::chrono::steady_clock::time_point m_start;
+			std::vector<char> m_buffer;
+
+			static constexpr size_t const buffer_size = 64 * 1024;
+
+		public:
+			// Creates or truncates path
+			explicit http_capture_writer( char const *path, bool const timestamps = true )
+			  : m_fd{::open( path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644 )}
+			  , m_timestamps{timestamps}
+			  , m_start{std::chrono::steady_clock::now( )}
+			  , m_buffer{} {
+				if( m_fd < 0 ) {
+					impl::throw_system_error( "open" );
+				}
+				m_buffer.reserve( buffer_size );
+				m_buffer.insert( m_buffer.end( ), std::begin( impl::http_capture_magic ),
+				                 std::end( impl::http_capture_magic ) );
+				impl::put_le( m_buffer, http_capture_version );
+				impl::put_le( m_buffer, timestamps ? http_capture_has_timestamps : 0U );
+			}
+
+			~http_capture_writer( ) noexcept {
+				if( m_fd >= 0 ) {
+					try {
+						flush( );
+					} catch( ... ) {}
+					::close( m_fd );
+				}
+			}
+
+			http_capture_writer( http_capture_writer const & ) = delete;
+			http_capture_writer &operator=( http_capture_writer const & ) = delete;
+
+			http_capture_writer( http_capture_writer &&other ) noexcept
+			  : m_fd{std::exchange( other.m_fd, -1 )}
+			  , m_timestamps{other.m_timestamps}
+			  , m_start{other.m_start}
+			  , m_buffer{std::move( other.m_buffer )} {}
+
+			http_capture_writer &operator=( http_capture_writer && ) = delete;
+
+			// Record data as read from stream, timestamped with the time since the writer was created
+			void write( uint32_t const stream, daw::string_view const data ) {
+				auto const elapsed = std::chrono::steady_clock::now( ) - m_start;
+				write( stream, data,
+				       static_cast<uint64_t>( std::chrono::duration_cast<std::chrono::nanoseconds>( elapsed ).count( ) ) );
+			}
+
+			// The timestamp is dropped when the capture has none
+			void write( uint32_t const stream, daw::string_view const data, uint64_t const timestamp_ns ) {
+				if( data.size( ) > 0xFFFF'FFFFULL ) {
+					throw daw::parser::invalid_input_exception{};
+				}
+				if( m_timestamps ) {
+					impl::put_le( m_buffer, timestamp_ns );
+				}
+				impl::put_le( m_buffer, stream );
+				impl::put_le( m_buffer, static_cast<uint32_t>( data.size( ) ) );
+				m_buffer.insert( m_buffer.end( ), data.begin( ), data.end( ) );
+				if( m_buffer.size( ) >= buffer_size ) {
+					flush( );
+				}
+			}
+
+			void flush( ) {
+				size_t pos = 0;
+				while( pos < m_buffer.size( ) ) {
+					auto const count = ::write( m_fd, m_buffer.data( ) + pos, m_buffer.size( ) - pos );
+					if( count < 0 ) {
+						if( errno == EINTR ) {
+							continue;
+						}
+						impl::throw_system_error( "write" );
+					}
+					pos += static_cast<size_t>( count );
+				}
+				m_buffer.clear( );
+			}
+		};
+
+		// Forward iterator over the records of a mapped capture.  A record that runs past the end of the file throws
+		struct http_capture_iterator {
+			using iterator_category = std::forward_iterator_tag;
+			using value_type = http_capture_record;
+			using difference_type = std::ptrdiff_t;
+			using pointer = http_capture_record const *;
+			using reference = http_capture_record const &;
+
+		private:
+			daw::string_view m_rest;
+			bool m_timestamps;
+			http_capture_record m_record;
+			size_t m_record_size;
+
+			void read_record( ) {
+				if( m_rest.empty( ) ) {
+					m_record_size = 0;
+					return;
+				}
+				size_t const prefix_size = ( m_timestamps ? 8 : 0 ) + 8;
+				if( m_rest.size( ) < prefix_size ) {
+					throw daw::parser::invalid_input_exception{};
+				}
+				auto ptr = m_rest.data( );
+				m_record.timestamp_ns = 0;
+				if( m_timestamps ) {
+					m_record.timestamp_ns = impl::get_le<uint64_t>( ptr );
+					ptr += 8;
+				}
+				m_record.stream = impl::get_le<uint32_t>( ptr );
+				auto const size = impl::get_le<uint32_t>( ptr + 4 );
+				if( size > m_rest.size( ) - prefix_size ) {
+					throw daw::parser::invalid_input_exception{};
+				}
+				m_record.data = daw::string_view{ptr + 8, size};
+				m_record_size = prefix_size + size;
+			}
+
+		public:
+			http_capture_iterator( ) noexcept : m_rest{}, m_timestamps{false}, m_record{0, 0, {}}, m_record_size{0} {}
+
+			http_capture_iterator( daw::string_view const records, bool const timestamps )
+			  : m_rest{records}, m_timestamps{timestamps}, m_record{0, 0, {}}, m_record_size{0} {
+				read_record( );
+			}
+
+			reference operator*( ) const noexcept {
+				return m_record;
+			}
+
+			pointer operator->( ) const noexcept {
+				return &m_record;
+			}
+
+			http_capture_iterator &operator++( ) {
+				m_rest.remove_prefix( m_record_size );
+				read_record( );
+				return *this;
+			}
+
+			http_capture_iterator operator++( int ) {
+				auto result = *this;
+				++( *this );
+				return result;
+			}
+
+			// Iterators are equal when they have the same amount left, the end has none
+			friend bool operator==( http_capture_iterator const &lhs, http_capture_iterator const &rhs ) noexcept {
+				return lhs.m_rest.size( ) == rhs.m_rest.size( );
+			}
+
+			friend bool operator!=( http_capture_iterator const &lhs, http_capture_iterator const &rhs ) noexcept {
+				return !( lhs == rhs );
+			}
+		};
+
+		// Maps a capture file read only.  The records and the views in them are valid while the reader is
+		struct http_capture_reader {
+		private:
+			char const *m_data;
+			size_t m_size;
+			bool m_timestamps;
+
+		public:
+			explicit http_capture_reader( char const *path ) : m_data{nullptr}, m_size{0}, m_timestamps{false} {
+				int const fd = ::open( path, O_RDONLY | O_CLOEXEC );
+				if( fd < 0 ) {
+					impl::throw_system_error( "open" );
+				}
+				struct stat info {};
+				if( ::fstat( fd, &info ) != 0 ) {
+					::close( fd );
+					impl::throw_system_error( "fstat" );
+				}
+				auto const size = static_cast<size_t>( info.st_size );
+				if( size < impl::http_capture_header_size ) {
+					::close( fd );
+					throw daw::parser::invalid_input_exception{};
+				}
+				void *const base = ::mmap( nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0 );
+				::close( fd );
+				if( base == MAP_FAILED ) {
+					impl::throw_system_error( "mmap" );
+				}
+				// Replay reads front to back
+				::madvise( base, size, MADV_SEQUENTIAL );
+				m_data = static_cast<char const *>( base );
+				m_size = size;
+				auto const version = impl::get_le<uint32_t>( m_data + 8 );
+				if( std::memcmp( m_data, impl::http_capture_magic, sizeof( impl::http_capture_magic ) ) != 0 ||
+				    version != http_capture_version ) {
+					::munmap( base, size );
+					m_data = nullptr;
+					throw daw::parser::invalid_input_exception{};
+				}
+				m_timestamps = ( impl::get_le<uint32_t>( m_data + 12 ) & http_capture_has_timestamps ) != 0;
+			}
+
+			~http_capture_reader( ) noexcept {
+				if( m_data != nullptr ) {
+					::munmap( const_cast<char *>( m_data ), m_size );
+				}
+			}
+
+			http_capture_reader( http_capture_reader const & ) = delete;
+			http_capture_reader &operator=( http_capture_reader const & ) = delete;
+
+			http_capture_reader( http_capture_reader &&other ) noexcept
+			  : m_data{std::exchange( other.m_data, nullptr )}, m_size{other.m_size}, m_timestamps{other.m_timestamps} {}
+
+			http_capture_reader &operator=( http_capture_reader && ) = delete;
+
+			bool has_timestamps( ) const noexcept {
+				return m_timestamps;
+			}
+
+			// The records, without the file header
+			daw::string_view records( ) const noexcept {
+				return daw::string_view{m_data + impl::http_capture_header_size, m_size - impl::http_capture_header_size};
+			}
+
+			http_capture_iterator begin( ) const {
+				return http_capture_iterator{records( ), m_timestamps};
+			}
+
+			http_capture_iterator end( ) const noexcept {
+				return http_capture_iterator{};
+			}
+		};
+
+		enum class http_replay_chunking : uint_fast8_t {
+			original, // each record as it was read
+			fixed,    // records cut into chunk_size pieces, the last piece of a record may be shorter
+			random    // records cut into pieces of 1 to chunk_size, the same seed gives the same cuts
+		};
+
+		struct http_replay_policy {
+			http_replay_chunking chunking = http_replay_chunking::original;
+			size_t chunk_size = 1;
+			uint64_t seed = 1;
+		};
+
+		// Call on_chunk( record, chunk ) for the chunks of every record of the capture in order.  The chunks are views
+		// into the mapping, nothing is copied.  Chunks never span records, so stream boundaries are kept
+		template<typename Callback>
+		void replay( http_capture_reader const &capture, http_replay_policy const &policy, Callback on_chunk ) {
+			auto const chunk_size = policy.chunk_size == 0 ? 1 : policy.chunk_size;
+			// xorshift64, the sequence is the same on every platform
+			uint64_t state = policy.seed == 0 ? 1 : policy.seed;
+			for( auto const &record : capture ) {
+				if( policy.chunking == http_replay_chunking::original ) {
+					on_chunk( record, record.data );
+					continue;
+				}
+				auto rest = record.data;
+				while( !rest.empty( ) ) {
+					size_t size = chunk_size;
+					if( policy.chunking == http_replay_chunking::random ) {
+						state ^= state << 13;
+						state ^= state >> 7;
+						state ^= state << 17;
+						size = 1 + static_cast<size_t>( state % chunk_size );
+					}
+					auto const chunk = rest.substr( 0, size );
+					rest.remove_prefix( chunk.size( ) );
+					on_chunk( record, chunk );
+				}
+			}
+		}
+	} // namespace http
+} // namespace daw
@@ -0,0 +1,490 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2017 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+// Reference I/O driver for the parser.  Linux only, it relies on memfd_create and epoll
+
+#include <cerrno>
+#include <cstddef>
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <system_error>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <daw/daw_parser_helper.h>
+#include <daw/daw_string_view.h>
+
+#include "http_header_cache.h"
+#include "http_headers.h"
+#include "http_limits.h"
+#include "http_proxy_protocol.h"
+#include "http_req_parser.h"
+#include "http_system_error.h"
+
+namespace daw {
+	namespace http {
+		namespace impl {
+			inline void set_non_blocking( int const fd ) {
+				auto const flags = ::fcntl( fd, F_GETFL, 0 );
+				if( flags < 0 || ::fcntl( fd, F_SETFL, flags | O_NONBLOCK ) < 0 ) {
+					throw_system_error( "fcntl" );
+				}
+			}
+		} // namespace impl
+
+		// Ring buffer whose storage is mapped twice, back to back.  The unread bytes are always contiguous in memory
+		// even when they wrap, so a request can be parsed in place wherever it lands
+		struct mirrored_buffer {
+		private:
+			char *m_data;
+			size_t m_capacity;
+			size_t m_head;
+			size_t m_size;
+
+		public:
+			// capacity is rounded up to a whole number of pages
+			explicit mirrored_buffer( size_t capacity ) : m_data{nullptr}, m_capacity{0}, m_head{0}, m_size{0} {
+				auto const page_size = static_cast<size_t>( ::sysconf( _SC_PAGESIZE ) );
+				capacity = ( ( capacity + page_size - 1 ) / page_size ) * page_size;
+				if( capacity == 0 ) {
+					capacity = page_size;
+				}
+				int const fd = ::memfd_create( "daw_http_buffer", MFD_CLOEXEC );
+				if( fd < 0 ) {
+					impl::throw_system_error( "memfd_create" );
+				}
+				if( ::ftruncate( fd, static_cast<off_t>( capacity ) ) != 0 ) {
+					::close( fd );
+					impl::throw_system_error( "ftruncate" );
+				}
+				void *const base = ::mmap( nullptr, 2 * capacity, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0 );
+				if( base == MAP_FAILED ) {
+					::close( fd );
+					impl::throw_system_error( "mmap" );
+				}
+				auto *const first = static_cast<char *>( base );
+				if( ::mmap( first, capacity, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0 ) == MAP_FAILED ||
+				    ::mmap( first + capacity, capacity, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0 ) ==
+				      MAP_FAILED ) {
+					::close( fd );
+					::munmap( base, 2 * capacity );
+					impl::throw_system_error( "mmap" );
+				}
+				::close( fd );
+				m_data = first;
+				m_capacity = capacity;
+			}
+
+			~mirrored_buffer( ) noexcept {
+				if( m_data != nullptr ) {
+					::munmap( m_data, 2 * m_capacity );
+				}
+			}
+
+			mirrored_buffer( mirrored_buffer const & ) = delete;
+			mirrored_buffer &operator=( mirrored_buffer const & ) = delete;
+
+			mirrored_buffer( mirrored_buffer &&other ) noexcept
+			  : m_data{std::exchange( other.m_data, nullptr )}
+			  , m_capacity{other.m_capacity}
+			  , m_head{other.m_head}
+			  , m_size{other.m_size} {}
+
+			mirrored_buffer &operator=( mirrored_buffer && ) = delete;
+
+			size_t capacity( ) const noexcept {
+				return m_capacity;
+			}
+
+			size_t size( ) const noexcept {
+				return m_size;
+			}
+
+			bool full( ) const noexcept {
+				return m_size == m_capacity;
+			}
+
+			// The unread bytes
+			daw::string_view data( ) const noexcept {
+				return daw::string_view{m_data + m_head, m_size};
+			}
+
+			// Where the next bytes go, writable( ) bytes are available there
+			char *write_position( ) noexcept {
+				return m_data + ( ( m_head + m_size ) % m_capacity );
+			}
+
+			size_t writable( ) const noexcept {
+				return m_capacity - m_size;
+			}
+
+			void commit( size_t const count ) noexcept {
+				m_size += count;
+			}
+
+			void consume( size_t const count ) noexcept {
+				m_head = ( m_head + count ) % m_capacity;
+				m_size -= count;
+			}
+		};
+
+		// A non-blocking socket and its receive buffer.  Requests are parsed where they were received and the views
+		// in request( ), headers( ) and body( ) stay valid until finish_request( )
+		struct http_connection {
+		private:
+			int m_fd;
+			mirrored_buffer m_buffer;
+			http_request m_request;
+			http_header_index m_headers;
+			daw::string_view m_body;
+			size_t m_request_size;
+			http_limits m_limits;
+			proxy_header m_proxy;
+			char m_proxy_paths[2 * impl::proxy_unix_path_size];
+			std::string m_proxy_tlvs;
+			bool m_proxy_pending;
+			http_header_cache m_header_cache;
+
+		public:
+			// Takes ownership of fd and makes it non-blocking.  A request head and body must fit in buffer_size
+			explicit http_connection( int const fd, size_t const buffer_size = 64 * 1024,
+			                          http_limits const &limits = http_limits{} )
+			  : m_fd{fd}
+			  , m_buffer{buffer_size}
+			  , m_request{}
+			  , m_headers{}
+			  , m_body{}
+			  , m_request_size{0}
+			  , m_limits{limits}
+			  , m_proxy{}
+			  , m_proxy_paths{}
+			  , m_proxy_tlvs{}
+			  , m_proxy_pending{false}
+			  , m_header_cache{} {
+				impl::set_non_blocking( m_fd );
+			}
+
+			~http_connection( ) noexcept {
+				if( m_fd >= 0 ) {
+					::close( m_fd );
+				}
+			}
+
+			http_connection( http_connection const & ) = delete;
+			http_connection &operator=( http_connection const & ) = delete;
+			http_connection( http_connection && ) = delete;
+			http_connection &operator=( http_connection && ) = delete;
+
+			int fd( ) const noexcept {
+				return m_fd;
+			}
+
+			// Read until the socket would block or the buffer is full.  Returns false once the peer has closed
+			bool fill( ) {
+				while( !m_buffer.full( ) ) {
+					auto const count = ::recv( m_fd, m_buffer.write_position( ), m_buffer.writable( ), 0 );
+					if( count > 0 ) {
+						m_buffer.commit( static_cast<size_t>( count ) );
+						continue;
+					}
+					if( count == 0 ) {
+						return false;
+					}
+					if( errno == EINTR ) {
+						continue;
+					}
+					if( errno == EAGAIN || errno == EWOULDBLOCK ) {
+						return true;
+					}
+					impl::throw_system_error( "recv" );
+				}
+				return true;
+			}
+
+			// Parse the next buffered request.  false when it has not completely arrived.  Throws when it cannot fit
+			// in the buffer or uses a transfer coding, only Content-Length bodies are supported
+			bool next_request( ) {
+				if( m_request_size != 0 ) {
+					return true;
+				}
+				auto const data = m_buffer.data( );
+				auto const head_size = parse_request_head( data, m_request, m_headers, m_header_cache, m_limits );
+				if( head_size == 0 ) {
+					if( m_buffer.full( ) ) {
+						throw daw::parser::invalid_input_exception{};
+					}
+					return false;
+				}
+				if( m_headers.contains( known_header::transfer_encoding ) ) {
+					throw daw::parser::invalid_input_exception{};
+				}
+				uint64_t body_size = 0;
+				if( m_headers.contains( known_header::content_length ) ) {
+					body_size = parse_to_value( m_headers[known_header::content_length], http_content_length{} );
+				}
+				if( body_size > m_buffer.capacity( ) - head_size ) {
+					throw daw::parser::invalid_input_exception{};
+				}
+				if( data.size( ) - head_size < body_size ) {
+					return false;
+				}
+				m_body = data.substr( head_size, static_cast<size_t>( body_size ) );
+				m_request_size = head_size + static_cast<size_t>( body_size );
+				return true;
+			}
+
+			// For listeners behind a load balancer that sends the PROXY protocol.  Call it instead of next_request until
+			// it returns true, the header is then removed from the buffer.  Throws when the connection does not start
+			// with a PROXY header.  The views in proxy( ) last as long as the connection
+			bool read_proxy_header( ) {
+				auto const size = parse_proxy_header( m_buffer.data( ), m_proxy );
+				if( size == 0 ) {
+					if( m_buffer.full( ) ) {
+						throw daw::parser::invalid_input_exception{};
+					}
+					return false;
+				}
+				// Addresses and ports are decoded already, only the unix paths and the TLVs still point into the buffer
+				auto const keep_path = [this]( daw::string_view &path, size_t const offset ) {
+					std::copy( path.begin( ), path.end( ), m_proxy_paths + offset );
+					path = daw::string_view{m_proxy_paths + offset, path.size( )};
+				};
+				keep_path( m_proxy.source_path, 0 );
+				keep_path( m_proxy.destination_path, impl::proxy_unix_path_size );
+				m_proxy_tlvs.assign( m_proxy.tlvs.data( ), m_proxy.tlvs.size( ) );
+				m_proxy.tlvs = daw::string_view{m_proxy_tlvs.data( ), m_proxy_tlvs.size( )};
+				m_buffer.consume( size );
+				m_proxy_pending = false;
+				return true;
+			}
+
+			// The connection must start with a PROXY header, see proxy_header_pending( )
+			void expect_proxy_header( ) noexcept {
+				m_proxy_pending = true;
+			}
+
+			// true from expect_proxy_header( ) until read_proxy_header( ) has consumed the header
+			bool proxy_header_pending( ) const noexcept {
+				return m_proxy_pending;
+			}
+
+			proxy_header const &proxy( ) const noexcept {
+				return m_proxy;
+			}
+
+			http_request const &request( ) const noexcept {
+				return m_request;
+			}
+
+			http_header_index const &headers( ) const noexcept {
+				return m_headers;
+			}
+
+			// How many header lines were reused from the previous request on this connection
+			http_header_cache_counters const &header_cache_counters( ) const noexcept {
+				return m_header_cache.counters( );
+			}
+
+			daw::string_view body( ) const noexcept {
+				return m_body;
+			}
+
+			// Release the current request's bytes, the next request on the connection can then be parsed
+			void finish_request( ) noexcept {
+				m_buffer.consume( m_request_size );
+				m_request_size = 0;
+				m_body = daw::string_view{};
+			}
+
+			// A request without "Connection: close" keeps the connection open( HTTP/1.1 ), HTTP/1.0 needs keep-alive
+			bool keep_alive( ) const noexcept {
+				auto const connection = m_headers[known_header::connection];
+				if( m_request.version.ver_major == 1 && m_request.version.ver_minor == 0 ) {
+					return header_has_token( connection, "keep-alive" );
+				}
+				return !header_has_token( connection, "close" );
+			}
+		};
+
+		// Level triggered epoll loop over listening sockets and connections.  handler( http_connection & ) is called
+		// once per complete request and can write its response to connection.fd( ).  Connections are closed on end
+		// of stream, on errors and after a request that does not keep the connection alive.  Connections from a
+		// PROXY protocol listener must send the header first, connection.proxy( ) then holds the original addresses
+		template<typename Handler>
+		struct http_epoll_server {
+		private:
+			struct listener {
+				int fd;
+				bool proxy_protocol;
+			};
+
+			int m_epoll;
+			Handler m_handler;
+			size_t m_buffer_size;
+			http_limits m_limits;
+			std::vector<listener> m_listeners;
+			std::unordered_map<int, std::unique_ptr<http_connection>> m_connections;
+
+			void watch( int const fd ) {
+				epoll_event ev{};
+				ev.events = EPOLLIN | EPOLLRDHUP;
+				ev.data.fd = fd;
+				if( ::epoll_ctl( m_epoll, EPOLL_CTL_ADD, fd, &ev ) != 0 ) {
+					impl::throw_system_error( "epoll_ctl" );
+				}
+			}
+
+			void accept_all( listener const &from ) {
+				while( true ) {
+					int const fd = ::accept4( from.fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC );
+					if( fd < 0 ) {
+						if( errno == EINTR ) {
+							continue;
+						}
+						if( errno == EAGAIN || errno == EWOULDBLOCK ) {
+							return;
+						}
+						impl::throw_system_error( "accept4" );
+					}
+					add_connection( fd, from.proxy_protocol );
+				}
+			}
+
+			// false when the connection should be closed
+			bool service( http_connection &connection ) {
+				try {
+					bool const open = connection.fill( );
+					if( connection.proxy_header_pending( ) && !connection.read_proxy_header( ) ) {
+						return open;
+					}
+					while( connection.next_request( ) ) {
+						m_handler( connection );
+						bool const keep_alive = connection.keep_alive( );
+						connection.finish_request( );
+						if( !keep_alive ) {
+							return false;
+						}
+					}
+					return open;
+				} catch( daw::parser::parser_exception const & ) {
+					return false;
+				} catch( std::system_error const & ) {
+					return false;
+				}
+			}
+
+		public:
+			explicit http_epoll_server( Handler handler, size_t const buffer_size = 64 * 1024,
+			                            http_limits const &limits = http_limits{} )
+			  : m_epoll{::epoll_create1( EPOLL_CLOEXEC )}
+			  , m_handler{std::move( handler )}
+			  , m_buffer_size{buffer_size}
+			  , m_limits{limits}
+			  , m_listeners{}
+			  , m_connections{} {
+				if( m_epoll < 0 ) {
+					impl::throw_system_error( "epoll_create1" );
+				}
+			}
+
+			~http_epoll_server( ) noexcept {
+				for( auto const &l : m_listeners ) {
+					::close( l.fd );
+				}
+				m_connections.clear( );
+				::close( m_epoll );
+			}
+
+			http_epoll_server( http_epoll_server const & ) = delete;
+			http_epoll_server &operator=( http_epoll_server const & ) = delete;
+
+			// Takes ownership of a bound and listening socket.  With proxy_protocol every connection accepted from it
+			// must start with a PROXY protocol header, it is read before the first request
+			void add_listener( int const fd, bool const proxy_protocol = false ) {
+				impl::set_non_blocking( fd );
+				watch( fd );
+				m_listeners.push_back( listener{fd, proxy_protocol} );
+			}
+
+			// Takes ownership of a connected socket
+			void add_connection( int const fd, bool const proxy_protocol = false ) {
+				auto connection = std::make_unique<http_connection>( fd, m_buffer_size, m_limits );
+				if( proxy_protocol ) {
+					connection->expect_proxy_header( );
+				}
+				watch( fd );
+				m_connections[fd] = std::move( connection );
+			}
+
+			size_t connection_count( ) const noexcept {
+				return m_connections.size( );
+			}
+
+			// Wait up to timeout_ms for activity and handle it.  Returns the number of ready descriptors
+			size_t poll( int const timeout_ms ) {
+				epoll_event events[64];
+				int const count = ::epoll_wait( m_epoll, events, 64, timeout_ms );
+				if( count < 0 ) {
+					if( errno == EINTR ) {
+						return 0;
+					}
+					impl::throw_system_error( "epoll_wait" );
+				}
+				for( int n = 0; n < count; ++n ) {
+					int const fd = events[n].data.fd;
+					auto const from = std::find_if( m_listeners.begin( ), m_listeners.end( ),
+					                                [fd]( listener const &l ) { return l.fd == fd; } );
+					if( from != m_listeners.end( ) ) {
+						accept_all( *from );
+						continue;
+					}
+					auto pos = m_connections.find( fd );
+					if( pos == m_connections.end( ) ) {
+						continue;
+					}
+					if( !service( *pos->second ) ) {
+						::epoll_ctl( m_epoll, EPOLL_CTL_DEL, fd, nullptr );
+						m_connections.erase( pos );
+					}
+				}
+				return static_cast<size_t>( count );
+			}
+		};
+
+		template<typename Handler>
+		auto make_http_epoll_server( Handler handler, size_t const buffer_size = 64 * 1024,
+		                             http_limits const &limits = http_limits{} ) {
+			return std::make_unique<http_epoll_server<Handler>>( std::move( handler ), buffer_size, limits );
+		}
+	} // namespace http
+} // namespace daw
@@ -0,0 +1,182 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2017 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+
+#include <daw/daw_string_view.h>
+
+#include "daw_parsing.h"
+#include "daw_swar.h"
+#include "http_headers.h"
+#include "http_req_parser.h"
+
+namespace daw {
+	namespace http {
+		// name and value are views into the Cookie header value.  The surrounding quotes of a quoted value are removed
+		struct http_cookie {
+			daw::string_view name;
+			daw::string_view value;
+
+			explicit constexpr operator bool( ) const noexcept {
+				return !name.empty( );
+			}
+		};
+
+		namespace impl {
+			constexpr daw::string_view unquote_cookie_value( daw::string_view value ) noexcept {
+				value = trim_ows( value );
+				if( value.size( ) >= 2 && value.front( ) == '"' && value.back( ) == '"' ) {
+					value = value.substr( 1, value.size( ) - 2 );
+				}
+				return value;
+			}
+
+			constexpr bool is_token( daw::string_view const str ) noexcept {
+				auto const result = daw::parsing::check_str<char_sets::tchar>( str );
+				return result.found && result.last == str.size( );
+			}
+
+			// Take the cookie-pair at the front of str and move str past the ';' that ends it.  Pairs without an '='
+			// or whose name is not a token are returned with an empty name
+			constexpr http_cookie take_cookie( daw::string_view &str ) noexcept {
+				while( !str.empty( ) && is_ows( str.front( ) ) ) {
+					str.remove_prefix( );
+				}
+				auto const pair_end = daw::swar::find( str, ';' );
+				auto const pair = str.substr( 0, pair_end );
+				str.remove_prefix( pair_end == daw::string_view::npos ? str.size( ) : pair_end + 1 );
+
+				auto const eq_pos = pair.find( '=' );
+				if( eq_pos == daw::string_view::npos || !is_token( pair.substr( 0, eq_pos ) ) ) {
+					return http_cookie{};
+				}
+				return http_cookie{pair.substr( 0, eq_pos ), unquote_cookie_value( pair.substr( eq_pos + 1 ) )};
+			}
+		} // namespace impl
+
+		// Forward iterator over the cookie-pairs of a Cookie header value.  Nothing is split until it is reached and
+		// malformed pairs are skipped
+		struct http_cookie_iterator {
+			using value_type = http_cookie;
+			using difference_type = std::ptrdiff_t;
+			using pointer = http_cookie const *;
+			using reference = http_cookie const &;
+			using iterator_category = std::forward_iterator_tag;
+
+		private:
+			daw::string_view m_rest;
+			http_cookie m_current;
+
+			constexpr void advance( ) noexcept {
+				m_current = http_cookie{};
+				while( !m_rest.empty( ) && !m_current ) {
+					m_current = impl::take_cookie( m_rest );
+				}
+			}
+
+		public:
+			constexpr http_cookie_iterator( ) noexcept : m_rest{}, m_current{} {}
+
+			explicit constexpr http_cookie_iterator( daw::string_view const header ) noexcept
+			  : m_rest{header}, m_current{} {
+				advance( );
+			}
+
+			constexpr reference operator*( ) const noexcept {
+				return m_current;
+			}
+
+			constexpr pointer operator->( ) const noexcept {
+				return &m_current;
+			}
+
+			constexpr http_cookie_iterator &operator++( ) noexcept {
+				advance( );
+				return *this;
+			}
+
+			constexpr http_cookie_iterator operator++( int ) noexcept {
+				http_cookie_iterator tmp{*this};
+				advance( );
+				return tmp;
+			}
+
+			// The end iterator is the only one without a current cookie
+			constexpr bool equal( http_cookie_iterator const &rhs ) const noexcept {
+				return m_current.name.data( ) == rhs.m_current.name.data( ) &&
+				       m_current.name.size( ) == rhs.m_current.name.size( );
+			}
+		};
+
+		constexpr bool operator==( http_cookie_iterator const &lhs, http_cookie_iterator const &rhs ) noexcept {
+			return lhs.equal( rhs );
+		}
+
+		constexpr bool operator!=( http_cookie_iterator const &lhs, http_cookie_iterator const &rhs ) noexcept {
+			return !lhs.equal( rhs );
+		}
+
+		struct http_cookie_view {
+			daw::string_view header;
+
+			constexpr http_cookie_iterator begin( ) const noexcept {
+				return http_cookie_iterator{header};
+			}
+
+			constexpr http_cookie_iterator end( ) const noexcept {
+				return http_cookie_iterator{};
+			}
+		};
+
+		constexpr http_cookie_view make_cookie_view( daw::string_view const header ) noexcept {
+			return http_cookie_view{header};
+		}
+
+		// Find the first cookie called name without splitting the others.  Pairs that do not start with name are
+		// skipped with a SWAR search for the next ';'.  The result is empty when it is not there
+		constexpr http_cookie find_cookie( daw::string_view header, daw::string_view const name ) noexcept {
+			if( name.empty( ) ) {
+				return http_cookie{};
+			}
+			while( !header.empty( ) ) {
+				while( !header.empty( ) && impl::is_ows( header.front( ) ) ) {
+					header.remove_prefix( );
+				}
+				if( header.size( ) > name.size( ) && header[name.size( )] == '=' &&
+				    header.substr( 0, name.size( ) ) == name ) {
+					auto const value_end = daw::swar::find( header, ';', name.size( ) + 1 );
+					auto const value = header.substr( 0, value_end ).substr( name.size( ) + 1 );
+					return http_cookie{header.substr( 0, name.size( ) ), impl::unquote_cookie_value( value )};
+				}
+				auto const next = daw::swar::find( header, ';' );
+				if( next == daw::string_view::npos ) {
+					break;
+				}
+				header.remove_prefix( next + 1 );
+			}
+			return http_cookie{};
+		}
+	} // namespace http
+} // namespace daw
@@ -0,0 +1,140 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2017 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <daw/daw_string_view.h>
+
+#include "daw_swar.h"
+#include "http_headers.h"
+#include "http_limits.h"
+#include "http_req_parser.h"
+
+namespace daw {
+	namespace http {
+		namespace impl {
+			constexpr uint64_t fingerprint_mix( uint64_t h ) noexcept {
+				h ^= h >> 33U;
+				h *= 0xff51'afd7'ed55'8ccdULL;
+				h ^= h >> 33U;
+				h *= 0xc4ce'b9fe'1a85'ec53ULL;
+				h ^= h >> 33U;
+				return h;
+			}
+
+			constexpr uint64_t fingerprint_step( uint64_t const h, uint64_t const word ) noexcept {
+				return ( ( h ^ word ) * 0x9e37'79b9'7f4a'7c15ULL ) ^ ( h >> 29U );
+			}
+
+			// Hash str 8 characters at a time, ending with its size so that adjacent fields cannot run together
+			template<bool FoldCase>
+			constexpr uint64_t fingerprint_text( uint64_t h, daw::string_view const str ) noexcept {
+				for( size_t pos = 0; pos < str.size( ); pos += 8 ) {
+					uint64_t word = daw::swar::load( str.data( ) + pos, str.size( ) - pos );
+					if( FoldCase ) {
+						word = to_lower( word );
+					}
+					h = fingerprint_step( h, word );
+				}
+				return fingerprint_step( h, str.size( ) );
+			}
+
+			struct fingerprint_host {
+				daw::string_view name;
+				uint16_t port;
+			};
+
+			// The target of an origin-form request has no host, it is in the Host header
+			inline fingerprint_host find_fingerprint_host( http_request const &request,
+			                                               http_header_index const &headers ) {
+				if( !request.uri.host.empty( ) ) {
+					return fingerprint_host{request.uri.host, request.uri.port};
+				}
+				auto const host = headers[known_header::host];
+				auto name = host;
+				daw::string_view port{};
+				if( !host.empty( ) && host.front( ) == '[' ) {
+					// an IPv6 literal has ':' in it, its brackets are dropped to match request.uri.host
+					auto const name_end = host.find( ']' );
+					if( name_end != daw::string_view::npos ) {
+						name = host.substr( 1, name_end - 1 );
+						if( name_end + 1 < host.size( ) && host[name_end + 1] == ':' ) {
+							port = host.substr( name_end + 2 );
+						}
+					}
+				} else {
+					auto const colon = host.find( ':' );
+					if( colon != daw::string_view::npos ) {
+						name = host.substr( 0, colon );
+						port = host.substr( colon + 1 );
+					}
+				}
+				// "host:" has an empty port, that is the default
+				return fingerprint_host{name,
+				                        port.empty( ) ? default_http_port : daw::swar::parse_unsigned<uint16_t>( port )};
+			}
+		} // namespace impl
+
+		// 64bit key for caching a request.  Equal for requests with the same method, host( case folded ), port( the
+		// default is the same as none ), path and the same query parameters in any order
+		inline uint64_t request_fingerprint( http_request const &request, http_header_index const &headers ) {
+			uint64_t h = impl::fingerprint_step( 0x243f'6a88'85a3'08d3ULL, static_cast<uint64_t>( request.method ) );
+
+			auto const host = impl::find_fingerprint_host( request, headers );
+			h = impl::fingerprint_text<true>( h, host.name );
+			h = impl::fingerprint_step( h, host.port == default_http_port ? 0 : host.port );
+
+			h = impl::fingerprint_text<false>( h, request.uri.path.empty( ) ? daw::string_view{"/"} : request.uri.path );
+
+			// Each parameter is hashed on its own and the results added so that their order does not matter
+			uint64_t params = 0;
+			uint64_t param_count = 0;
+			auto query = request.uri.query;
+			while( !query.empty( ) ) {
+				auto const amp = daw::swar::find( query, '&' );
+				auto const param = query.substr( 0, amp );
+				if( !param.empty( ) ) {
+					params += impl::fingerprint_mix( impl::fingerprint_text<false>( 0x1319'8a2e'0370'7344ULL, param ) );
+					++param_count;
+				}
+				query.remove_prefix( amp == daw::string_view::npos ? query.size( ) : amp + 1 );
+			}
+			h = impl::fingerprint_step( h, params );
+			h = impl::fingerprint_step( h, param_count );
+			return impl::fingerprint_mix( h );
+		}
+
+		// parse_request_head that also computes the request_fingerprint while the head is still in cache.  fingerprint
+		// is only set when the head is complete
+		inline size_t parse_request_head( daw::string_view const str, http_request &request, http_header_index &headers,
+		                                  uint64_t &fingerprint, http_limits const &limits = http_limits{} ) {
+			auto const size = parse_request_head( str, request, headers, limits );
+			if( size != 0 ) {
+				fingerprint = request_fingerprint( request, headers );
+			}
+			return size;
+		}
+	} // namespace http
+} // namespace daw
@@ -0,0 +1,154 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2017 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+
+#include <daw/daw_parser_helper.h>
+#include <daw/daw_string_view.h>
+
+#include "daw_swar.h"
+#include "hex_digits.h"
+#include "http_limits.h"
+
+namespace daw {
+	namespace http {
+		// One name=value pair of an application/x-www-form-urlencoded body.  Both are still encoded, form_decode
+		// gives the text
+		struct http_form_field {
+			daw::string_view key;
+			daw::string_view value;
+		};
+
+		namespace impl {
+			constexpr http_form_field split_form_field( daw::string_view const pair ) noexcept {
+				auto const eq = daw::swar::find( pair, '=' );
+				if( eq == daw::string_view::npos ) {
+					return http_form_field{pair, daw::string_view{}};
+				}
+				return http_form_field{pair.substr( 0, eq ), pair.substr( eq + 1 )};
+			}
+		} // namespace impl
+
+		// Decode a form encoded key or value into out, which needs room for encoded.size( ) characters.  Escapes are
+		// read like percent_decode_iterator does, '%' and two hex digits of either case, and '+' is a space.  Returns
+		// the decoded size
+		inline size_t form_decode( daw::string_view const encoded, char *const out ) {
+			size_t out_pos = 0;
+			size_t pos = 0;
+			while( pos < encoded.size( ) ) {
+				// runs without escapes or '+' are copied as is
+				auto const pct = daw::swar::find( encoded, '%', pos );
+				auto const end = pct == daw::string_view::npos ? encoded.size( ) : pct;
+				for( ; pos < end; ++pos ) {
+					out[out_pos++] = encoded[pos] == '+' ? ' ' : encoded[pos];
+				}
+				if( pos == encoded.size( ) ) {
+					break;
+				}
+				if( encoded.size( ) - pos < 3 || !impl::is_hex_digit( encoded[pos + 1] ) ||
+				    !impl::is_hex_digit( encoded[pos + 2] ) ) {
+					throw daw::parser::invalid_input_exception{};
+				}
+				out[out_pos++] =
+				  static_cast<char>( ( impl::hex_value( encoded[pos + 1] ) << 4 ) | impl::hex_value( encoded[pos + 2] ) );
+				pos += 3;
+			}
+			return out_pos;
+		}
+
+		// Splits a form encoded body that arrives in chunks.  Pairs that are complete within a chunk are passed on as
+		// views into that chunk.  Only a pair that straddles chunks is copied, into a spill buffer of SpillSize
+		// characters, so the memory used does not depend on the size of the body.  A pair larger than the spill
+		// buffer throws http_limit_exceeded_exception
+		template<size_t SpillSize = 4 * 1024>
+		struct basic_http_form_parser {
+		private:
+			char m_spill[SpillSize];
+			size_t m_spill_size;
+
+			void spill( daw::string_view const str ) {
+				if( str.size( ) > SpillSize - m_spill_size ) {
+					throw http_limit_exceeded_exception{};
+				}
+				std::memcpy( m_spill + m_spill_size, str.data( ), str.size( ) );
+				m_spill_size += str.size( );
+			}
+
+			template<typename Callback>
+			static void emit( daw::string_view const pair, Callback &on_field ) {
+				if( !pair.empty( ) ) {
+					on_field( impl::split_form_field( pair ) );
+				}
+			}
+
+			template<typename Callback>
+			void emit_spill( Callback &on_field ) {
+				auto const pair = daw::string_view{m_spill, m_spill_size};
+				m_spill_size = 0;
+				emit( pair, on_field );
+			}
+
+		public:
+			basic_http_form_parser( ) noexcept : m_spill{}, m_spill_size{0} {}
+
+			// Calls on_field( http_form_field ) for every pair completed by chunk.  The views are only valid during
+			// the call
+			template<typename Callback>
+			void parse( daw::string_view chunk, Callback on_field ) {
+				if( m_spill_size != 0 ) {
+					auto const amp = daw::swar::find( chunk, '&' );
+					if( amp == daw::string_view::npos ) {
+						spill( chunk );
+						return;
+					}
+					spill( chunk.substr( 0, amp ) );
+					emit_spill( on_field );
+					chunk.remove_prefix( amp + 1 );
+				}
+				while( !chunk.empty( ) ) {
+					auto const amp = daw::swar::find( chunk, '&' );
+					if( amp == daw::string_view::npos ) {
+						spill( chunk );
+						return;
+					}
+					emit( chunk.substr( 0, amp ), on_field );
+					chunk.remove_prefix( amp + 1 );
+				}
+			}
+
+			// The body has ended, pass on the last pair
+			template<typename Callback>
+			void finish( Callback on_field ) {
+				emit_spill( on_field );
+			}
+
+			void reset( ) noexcept {
+				m_spill_size = 0;
+			}
+		};
+
+		using http_form_parser = basic_http_form_parser<>;
+	} // namespace http
+} // namespace daw
@@ -0,0 +1,208 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2017 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include <daw/daw_parser_helper.h>
+#include <daw/daw_string_view.h>
+
+#include "daw_swar.h"
+#include "http_headers.h"
+#include "http_limits.h"
+#include "http_req_parser.h"
+
+namespace daw {
+	namespace http {
+		struct http_header_cache_counters {
+			uint64_t reused; // lines taken from the previous block
+			uint64_t parsed; // lines parsed in full
+		};
+
+		// The header block of the previous request on a connection, copied, with where the name and value of each line
+		// are.  Keep-alive clients repeat most lines byte for byte, so a line that compares equal to a stored one,
+		// CRLF included, gets the stored parse without being scanned.  Lines that changed are parsed as usual.
+		// Lines that do not fit in StorageSize are not remembered
+		template<size_t StorageSize = 8 * 1024>
+		struct basic_http_header_cache {
+			static constexpr size_t const max_lines = http_header_index::capacity;
+
+		private:
+			struct cached_line {
+				uint64_t prefix; // the first 8 characters, fewer for shorter lines, rejects most mismatches early
+				uint32_t offset;
+				uint32_t size;
+				uint32_t name_size;
+				uint32_t value_offset;
+				uint32_t value_size;
+				known_header id;
+			};
+
+			cached_line m_lines[max_lines];
+			size_t m_count;
+			http_header_cache_counters m_counters;
+			char m_storage[StorageSize];
+
+			static uint64_t line_prefix( char const *ptr, size_t const size ) noexcept {
+				return daw::swar::load( ptr, size < 8 ? size : 8 );
+			}
+
+			// Index of the stored line at the front of str, m_count if there is none.  The line after the previous hit is
+			// tried first as clients usually send their headers in the same order
+			size_t find_line( daw::string_view const str, size_t const expected ) const noexcept {
+				uint64_t const word = daw::swar::load( str );
+				auto const matches = [&]( cached_line const &line ) {
+					return line.size <= str.size( ) && line.prefix == ( word & daw::swar::prefix_mask( line.size ) ) &&
+					       std::memcmp( m_storage + line.offset, str.data( ), line.size ) == 0;
+				};
+				if( expected < m_count && matches( m_lines[expected] ) ) {
+					return expected;
+				}
+				for( size_t n = 0; n < m_count; ++n ) {
+					if( n != expected && matches( m_lines[n] ) ) {
+						return n;
+					}
+				}
+				return m_count;
+			}
+
+			void store( daw::string_view const block, cached_line const *lines, size_t const count ) noexcept {
+				size_t const stored_size = block.size( ) < StorageSize ? block.size( ) : StorageSize;
+				std::memcpy( m_storage, block.data( ), stored_size );
+				m_count = 0;
+				for( size_t n = 0; n < count && lines[n].offset + lines[n].size <= stored_size; ++n ) {
+					m_lines[m_count++] = lines[n];
+				}
+			}
+
+		public:
+			basic_http_header_cache( ) noexcept : m_lines{}, m_count{0}, m_counters{0, 0}, m_storage{} {}
+
+			basic_http_header_cache( basic_http_header_cache const & ) = delete;
+			basic_http_header_cache &operator=( basic_http_header_cache const & ) = delete;
+
+			// Same as parse_headers( str, headers, limits ).  A complete block replaces the stored one, unless it is the
+			// stored one
+			size_t parse_headers( daw::string_view str, http_header_index &headers,
+			                      http_limits const &limits = http_limits{} ) {
+				headers.clear( );
+				bool const truncated = str.size( ) > limits.max_header_bytes;
+				if( truncated ) {
+					str = str.substr( 0, limits.max_header_bytes );
+				}
+				cached_line lines[max_lines];
+				// only added to m_counters once the block is complete, a partial block is parsed again later
+				http_header_cache_counters counted{0, 0};
+				bool unchanged = true;
+				size_t expected = 0;
+				size_t pos = 0;
+				while( str.size( ) - pos >= 2 ) {
+					if( str[pos] == '\r' ) {
+						if( str[pos + 1] != '\n' ) {
+							throw daw::parser::invalid_input_exception{};
+						}
+						if( !unchanged || headers.size( ) != m_count ) {
+							store( str.substr( 0, pos ), lines, headers.size( ) );
+						}
+						m_counters.reused += counted.reused;
+						m_counters.parsed += counted.parsed;
+						return pos + 2;
+					}
+					if( headers.size( ) >= max_header_count( limits ) ) {
+						throw http_limit_exceeded_exception{};
+					}
+					auto const rest = str.substr( pos );
+					auto const idx = find_line( rest, expected );
+					cached_line line;
+					if( idx < m_count ) {
+						line = m_lines[idx];
+						unchanged = unchanged && idx == headers.size( ) && line.offset == pos;
+						expected = idx + 1;
+						++counted.reused;
+					} else {
+						auto const parsed = parse_header_line( rest );
+						if( parsed.size == 0 ) {
+							break;
+						}
+						line.prefix = line_prefix( rest.data( ), parsed.size );
+						line.size = static_cast<uint32_t>( parsed.size );
+						line.name_size = static_cast<uint32_t>( parsed.header.name.size( ) );
+						line.value_offset = static_cast<uint32_t>( parsed.header.value.data( ) - rest.data( ) );
+						line.value_size = static_cast<uint32_t>( parsed.header.value.size( ) );
+						line.id = parsed.header.id;
+						unchanged = false;
+						++counted.parsed;
+					}
+					line.offset = static_cast<uint32_t>( pos );
+					headers.push_back( http_header{rest.substr( 0, line.name_size ),
+					                               rest.substr( line.value_offset, line.value_size ), line.id} );
+					lines[headers.size( ) - 1] = line;
+					pos += line.size;
+				}
+				if( truncated ) {
+					throw http_limit_exceeded_exception{};
+				}
+				return 0;
+			}
+
+			// Forget the stored block, e.g. when the connection is reused for another client
+			void clear( ) noexcept {
+				m_count = 0;
+			}
+
+			size_t size( ) const noexcept {
+				return m_count;
+			}
+
+			http_header_cache_counters const &counters( ) const noexcept {
+				return m_counters;
+			}
+
+			static constexpr size_t storage_size( ) noexcept {
+				return StorageSize;
+			}
+		};
+
+		using http_header_cache = basic_http_header_cache<>;
+
+		// parse_request_head with the header lines going through cache
+		template<size_t StorageSize>
+		size_t parse_request_head( daw::string_view const str, http_request &request, http_header_index &headers,
+		                           basic_http_header_cache<StorageSize> &cache,
+		                           http_limits const &limits = http_limits{} ) {
+			auto const line_end = impl::scan_request_line( str, limits );
+			if( line_end == daw::string_view::npos ) {
+				return 0;
+			}
+			auto const header_size = cache.parse_headers( str.substr( line_end + 2 ), headers, limits );
+			if( header_size == 0 ) {
+				return 0;
+			}
+			request = parse_request_line( str.substr( 0, line_end ) );
+			request.headers_present = headers.present( );
+			return line_end + 2 + header_size;
+		}
+	} // namespace http
+} // namespace daw
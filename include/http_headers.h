@@ -0,0 +1,468 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2017 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <daw/daw_parser_helper.h>
+#include <daw/daw_string_view.h>
+
+#include "daw_swar.h"
+#include "http_limits.h"
+
+namespace daw {
+	namespace http {
+		// Lower case names are in impl::known_header_names, in the same order
+		enum class known_header : uint8_t {
+			accept = 0,
+			accept_charset,
+			accept_encoding,
+			accept_language,
+			accept_ranges,
+			age,
+			authorization,
+			cache_control,
+			connection,
+			content_disposition,
+			content_encoding,
+			content_language,
+			content_length,
+			content_location,
+			content_range,
+			content_type,
+			cookie,
+			date,
+			etag,
+			expect,
+			expires,
+			forwarded,
+			from,
+			host,
+			if_match,
+			if_modified_since,
+			if_none_match,
+			if_range,
+			if_unmodified_since,
+			keep_alive,
+			last_modified,
+			location,
+			max_forwards,
+			origin,
+			pragma,
+			proxy_authorization,
+			range,
+			referer,
+			retry_after,
+			server,
+			set_cookie,
+			te,
+			trailer,
+			transfer_encoding,
+			upgrade,
+			user_agent,
+			vary,
+			via,
+			www_authenticate,
+			x_forwarded_for,
+			x_forwarded_host,
+			x_forwarded_proto,
+			x_real_ip,
+			x_request_id,
+			unknown
+		};
+
+		constexpr size_t const known_header_count = static_cast<size_t>( known_header::unknown );
+		static_assert( known_header_count <= 64, "known_header_set is a 64bit bitmap" );
+
+		namespace impl {
+			constexpr daw::string_view const known_header_names[known_header_count] = {"accept",
+			                                                                           "accept-charset",
+			                                                                           "accept-encoding",
+			                                                                           "accept-language",
+			                                                                           "accept-ranges",
+			                                                                           "age",
+			                                                                           "authorization",
+			                                                                           "cache-control",
+			                                                                           "connection",
+			                                                                           "content-disposition",
+			                                                                           "content-encoding",
+			                                                                           "content-language",
+			                                                                           "content-length",
+			                                                                           "content-location",
+			                                                                           "content-range",
+			                                                                           "content-type",
+			                                                                           "cookie",
+			                                                                           "date",
+			                                                                           "etag",
+			                                                                           "expect",
+			                                                                           "expires",
+			                                                                           "forwarded",
+			                                                                           "from",
+			                                                                           "host",
+			                                                                           "if-match",
+			                                                                           "if-modified-since",
+			                                                                           "if-none-match",
+			                                                                           "if-range",
+			                                                                           "if-unmodified-since",
+			                                                                           "keep-alive",
+			                                                                           "last-modified",
+			                                                                           "location",
+			                                                                           "max-forwards",
+			                                                                           "origin",
+			                                                                           "pragma",
+			                                                                           "proxy-authorization",
+			                                                                           "range",
+			                                                                           "referer",
+			                                                                           "retry-after",
+			                                                                           "server",
+			                                                                           "set-cookie",
+			                                                                           "te",
+			                                                                           "trailer",
+			                                                                           "transfer-encoding",
+			                                                                           "upgrade",
+			                                                                           "user-agent",
+			                                                                           "vary",
+			                                                                           "via",
+			                                                                           "www-authenticate",
+			                                                                           "x-forwarded-for",
+			                                                                           "x-forwarded-host",
+			                                                                           "x-forwarded-proto",
+			                                                                           "x-real-ip",
+			                                                                           "x-request-id"};
+
+			// ASCII upper case letters in all 8 lanes are lowered, everything else is left alone
+			constexpr uint64_t to_lower( uint64_t const word ) noexcept {
+				return word | ( daw::swar::bytes_between( word, 'A', 'Z' ) >> 2 );
+			}
+
+			// The multiplier was searched for so that every known name lands in its own slot.  The key is the lower
+			// cased first and last 8 characters and the length, make_known_header_table verifies it
+			constexpr uint64_t const known_header_hash_multiplier = 0x9c38'8b98'6f81'5d2fULL;
+			constexpr size_t const known_header_hash_bits = 7;
+			constexpr size_t const known_header_slot_count = 1U << known_header_hash_bits;
+
+			constexpr size_t known_header_hash( daw::string_view const name ) noexcept {
+				uint64_t const first = to_lower( daw::swar::load( name ) );
+				uint64_t const last =
+				  name.size( ) >= 8 ? to_lower( daw::swar::load( name.data( ) + name.size( ) - 8, 8 ) ) : first;
+				uint64_t const key = first ^ ( last << 1 ) ^ name.size( );
+				return static_cast<size_t>( ( key * known_header_hash_multiplier ) >> ( 64 - known_header_hash_bits ) );
+			}
+
+			struct known_header_table {
+				known_header slots[known_header_slot_count];
+				bool is_perfect;
+			};
+
+			constexpr known_header_table make_known_header_table( ) noexcept {
+				known_header_table result{{}, true};
+				for( auto &slot : result.slots ) {
+					slot = known_header::unknown;
+				}
+				for( size_t n = 0; n < known_header_count; ++n ) {
+					auto &slot = result.slots[known_header_hash( known_header_names[n] )];
+					if( slot != known_header::unknown ) {
+						result.is_perfect = false;
+					}
+					slot = static_cast<known_header>( n );
+				}
+				return result;
+			}
+
+			constexpr known_header_table const known_header_lookup = make_known_header_table( );
+			static_assert( known_header_lookup.is_perfect, "Known header hash has collisions" );
+
+			// Case insensitive compare of two names of the same size, a word at a time
+			constexpr bool equal_ignore_case( daw::string_view const lhs, daw::string_view const rhs ) noexcept {
+				for( size_t pos = 0; pos < lhs.size( ); pos += 8 ) {
+					auto const count = lhs.size( ) - pos;
+					if( to_lower( daw::swar::load( lhs.data( ) + pos, count ) ) !=
+					    to_lower( daw::swar::load( rhs.data( ) + pos, count ) ) ) {
+						return false;
+					}
+				}
+				return true;
+			}
+		} // namespace impl
+
+		constexpr daw::string_view to_string( known_header const header ) noexcept {
+			return header == known_header::unknown ? daw::string_view{}
+			                                       : impl::known_header_names[static_cast<size_t>( header )];
+		}
+
+		// Case insensitive, O(1) lookup of a field name
+		constexpr known_header find_known_header( daw::string_view const name ) noexcept {
+			auto const candidate = impl::known_header_lookup.slots[impl::known_header_hash( name )];
+			if( candidate == known_header::unknown ) {
+				return candidate;
+			}
+			auto const known = impl::known_header_names[static_cast<size_t>( candidate )];
+			if( known.size( ) != name.size( ) || !impl::equal_ignore_case( name, known ) ) {
+				return known_header::unknown;
+			}
+			return candidate;
+		}
+
+		struct known_header_set {
+			uint64_t bits;
+
+			constexpr bool contains( known_header const header ) const noexcept {
+				return header != known_header::unknown && ( ( bits >> static_cast<size_t>( header ) ) & 1U ) != 0;
+			}
+
+			constexpr void insert( known_header const header ) noexcept {
+				if( header != known_header::unknown ) {
+					bits |= 1ULL << static_cast<size_t>( header );
+				}
+			}
+		};
+
+		struct http_header {
+			daw::string_view name;
+			daw::string_view value;
+			known_header id;
+		};
+
+		struct header_line_result {
+			http_header header;
+			size_t size; // 0 when the line is not complete yet
+		};
+
+		namespace impl {
+			constexpr bool is_ows( char const c ) noexcept {
+				return c == ' ' || c == '\t';
+			}
+
+			// Size of the field name, npos when the ':' has not arrived yet.  Only visible characters are allowed so
+			// whitespace before the ':' and obsolete line folding are rejected
+			constexpr size_t scan_header_name( daw::string_view const str ) {
+				size_t pos = 0;
+				while( pos < str.size( ) ) {
+					uint64_t const word = daw::swar::load( str.data( ) + pos, str.size( ) - pos );
+					uint64_t const name_chars =
+					  daw::swar::bytes_between( word, 0x21, 0x7E ) & ~daw::swar::bytes_equal( word, ':' );
+					size_t const count = daw::swar::leading_set_bytes( name_chars );
+					pos += count;
+					if( count < 8 ) {
+						if( pos >= str.size( ) ) {
+							break;
+						}
+						if( pos == 0 || str[pos] != ':' ) {
+							throw daw::parser::invalid_input_exception{};
+						}
+						return pos;
+					}
+				}
+				return daw::string_view::npos;
+			}
+
+			// Position of the CR of the CRLF ending the line, searching from pos.  npos when it has not arrived yet.
+			// Control characters other than HTAB are invalid, obs-text is allowed
+			constexpr size_t find_line_end( daw::string_view const str, size_t pos ) {
+				while( pos < str.size( ) ) {
+					uint64_t const word = daw::swar::load( str.data( ) + pos, str.size( ) - pos );
+					uint64_t const allowed = daw::swar::bytes_between( word, 0x20, 0x7E ) |
+					                         daw::swar::bytes_equal( word, '\t' ) | ( word & daw::swar::hi_bits );
+					size_t const count = daw::swar::leading_set_bytes( allowed );
+					pos += count;
+					if( count < 8 ) {
+						if( pos >= str.size( ) ) {
+							break;
+						}
+						if( str[pos] != '\r' ) {
+							throw daw::parser::invalid_input_exception{};
+						}
+						if( pos + 1 >= str.size( ) ) {
+							break;
+						}
+						if( str[pos + 1] != '\n' ) {
+							throw daw::parser::invalid_input_exception{};
+						}
+						return pos;
+					}
+				}
+				return daw::string_view::npos;
+			}
+
+			constexpr daw::string_view trim_ows( daw::string_view str ) noexcept {
+				while( !str.empty( ) && is_ows( str.front( ) ) ) {
+					str.remove_prefix( );
+				}
+				while( !str.empty( ) && is_ows( str.back( ) ) ) {
+					str.remove_suffix( );
+				}
+				return str;
+			}
+		} // namespace impl
+
+		// Parse one "name: value CRLF" line from the front of str
+		constexpr header_line_result parse_header_line( daw::string_view const str ) {
+			header_line_result result{{}, 0};
+			auto const name_size = impl::scan_header_name( str );
+			if( name_size == daw::string_view::npos ) {
+				return result;
+			}
+			auto const line_end = impl::find_line_end( str, name_size + 1 );
+			if( line_end == daw::string_view::npos ) {
+				return result;
+			}
+			result.header.name = str.substr( 0, name_size );
+			result.header.value = impl::trim_ows( str.substr( name_size + 1, line_end - ( name_size + 1 ) ) );
+			result.header.id = find_known_header( result.header.name );
+			result.size = line_end + 2;
+			return result;
+		}
+
+		// Fixed capacity list of the headers of one message.  Known headers are found with an array read, the first
+		// occurrence is returned when a header is repeated
+		struct http_header_index {
+			static constexpr size_t const capacity = 64;
+
+		private:
+			http_header m_headers[capacity];
+			size_t m_size;
+			known_header_set m_present;
+			uint8_t m_first[known_header_count];
+
+		public:
+			http_header_index( ) noexcept : m_headers{}, m_size{0}, m_present{0}, m_first{} {}
+
+			void clear( ) noexcept {
+				m_size = 0;
+				m_present = known_header_set{0};
+			}
+
+			// Throws when there are more than capacity headers
+			void push_back( http_header const &header ) {
+				if( m_size == capacity ) {
+					throw daw::parser::invalid_input_exception{};
+				}
+				if( header.id != known_header::unknown && !m_present.contains( header.id ) ) {
+					m_present.insert( header.id );
+					m_first[static_cast<size_t>( header.id )] = static_cast<uint8_t>( m_size );
+				}
+				m_headers[m_size++] = header;
+			}
+
+			size_t size( ) const noexcept {
+				return m_size;
+			}
+
+			bool empty( ) const noexcept {
+				return m_size == 0;
+			}
+
+			http_header const *begin( ) const noexcept {
+				return m_headers;
+			}
+
+			http_header const *end( ) const noexcept {
+				return m_headers + m_size;
+			}
+
+			known_header_set present( ) const noexcept {
+				return m_present;
+			}
+
+			bool contains( known_header const header ) const noexcept {
+				return m_present.contains( header );
+			}
+
+			// Value of the first header with that id, empty if not present
+			daw::string_view operator[]( known_header const header ) const noexcept {
+				if( !m_present.contains( header ) ) {
+					return daw::string_view{};
+				}
+				return m_headers[m_first[static_cast<size_t>( header )]].value;
+			}
+
+			// Case insensitive search, known names go through the index
+			http_header const *find( daw::string_view const name ) const noexcept {
+				auto const id = find_known_header( name );
+				if( id != known_header::unknown ) {
+					return m_present.contains( id ) ? &m_headers[m_first[static_cast<size_t>( id )]] : end( );
+				}
+				for( auto const &header : *this ) {
+					if( header.id == known_header::unknown && header.name.size( ) == name.size( ) &&
+					    impl::equal_ignore_case( header.name, name ) ) {
+						return &header;
+					}
+				}
+				return end( );
+			}
+		};
+
+		// Header lines allowed by limits, limits.max_headers but never more than an http_header_index holds
+		constexpr size_t max_header_count( http_limits const &limits ) noexcept {
+			size_t const capacity = http_header_index::capacity;
+			return limits.max_headers < capacity ? limits.max_headers : capacity;
+		}
+
+		// true when the comma separated list in value, e.g. a Connection header, has token in it.  Case insensitive
+		constexpr bool header_has_token( daw::string_view value, daw::string_view const token ) noexcept {
+			while( !value.empty( ) ) {
+				auto const item_end = value.find( ',' );
+				auto const item = impl::trim_ows( value.substr( 0, item_end ) );
+				if( item.size( ) == token.size( ) && impl::equal_ignore_case( item, token ) ) {
+					return true;
+				}
+				value.remove_prefix( item_end == daw::string_view::npos ? value.size( ) : item_end + 1 );
+			}
+			return false;
+		}
+
+		// Parse header lines up to and including the empty line that ends them.  Returns the number of characters
+		// used or 0 when the block is not complete yet.  Nothing past limits.max_header_bytes is looked at
+		inline size_t parse_headers( daw::string_view str, http_header_index &headers,
+		                             http_limits const &limits = http_limits{} ) {
+			headers.clear( );
+			bool const truncated = str.size( ) > limits.max_header_bytes;
+			if( truncated ) {
+				str = str.substr( 0, limits.max_header_bytes );
+			}
+			size_t pos = 0;
+			while( str.size( ) - pos >= 2 ) {
+				if( str[pos] == '\r' ) {
+					if( str[pos + 1] != '\n' ) {
+						throw daw::parser::invalid_input_exception{};
+					}
+					return pos + 2;
+				}
+				if( headers.size( ) >= max_header_count( limits ) ) {
+					throw http_limit_exceeded_exception{};
+				}
+				auto const line = parse_header_line( str.substr( pos ) );
+				if( line.size == 0 ) {
+					break;
+				}
+				headers.push_back( line.header );
+				pos += line.size;
+			}
+			if( truncated ) {
+				throw http_limit_exceeded_exception{};
+			}
+			return 0;
+		}
+	} // namespace http
+} // namespace daw
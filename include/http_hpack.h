@@ -0,0 +1,719 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2017 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include <daw/daw_parser_helper.h>
+#include <daw/daw_string_view.h>
+
+#include "daw_swar.h"
+#include "http_headers.h"
+#include "http_limits.h"
+#include "http_req_parser.h"
+
+namespace daw {
+	namespace http {
+		// A header block could not be decoded.  The dynamic table is out of step with the peer's encoder after this,
+		// so it is a connection error( COMPRESSION_ERROR ) and the decoder must not be used again
+		struct hpack_compression_exception : daw::parser::invalid_input_exception {};
+
+		namespace impl {
+			struct hpack_static_entry {
+				daw::string_view name;
+				daw::string_view value;
+			};
+
+			// RFC 7541 Appendix A, index 1 is element 0
+			constexpr size_t const hpack_static_table_size = 61;
+			constexpr hpack_static_entry const hpack_static_table[hpack_static_table_size] = {
+			  {":authority", ""},
+			  {":method", "GET"},
+			  {":method", "POST"},
+			  {":path", "/"},
+			  {":path", "/index.html"},
+			  {":scheme", "http"},
+			  {":scheme", "https"},
+			  {":status", "200"},
+			  {":status", "204"},
+			  {":status", "206"},
+			  {":status", "304"},
+			  {":status", "400"},
+			  {":status", "404"},
+			  {":status", "500"},
+			  {"accept-charset", ""},
+			  {"accept-encoding", "gzip, deflate"},
+			  {"accept-language", ""},
+			  {"accept-ranges", ""},
+			  {"accept", ""},
+			  {"access-control-allow-origin", ""},
+			  {"age", ""},
+			  {"allow", ""},
+			  {"authorization", ""},
+			  {"cache-control", ""},
+			  {"content-disposition", ""},
+			  {"content-encoding", ""},
+			  {"content-language", ""},
+			  {"content-length", ""},
+			  {"content-location", ""},
+			  {"content-range", ""},
+			  {"content-type", ""},
+			  {"cookie", ""},
+			  {"date", ""},
+			  {"etag", ""},
+			  {"expect", ""},
+			  {"expires", ""},
+			  {"from", ""},
+			  {"host", ""},
+			  {"if-match", ""},
+			  {"if-modified-since", ""},
+			  {"if-none-match", ""},
+			  {"if-range", ""},
+			  {"if-unmodified-since", ""},
+			  {"last-modified", ""},
+			  {"link", ""},
+			  {"location", ""},
+			  {"max-forwards", ""},
+			  {"proxy-authenticate", ""},
+			  {"proxy-authorization", ""},
+			  {"range", ""},
+			  {"referer", ""},
+			  {"refresh", ""},
+			  {"retry-after", ""},
+			  {"server", ""},
+			  {"set-cookie", ""},
+			  {"strict-transport-security", ""},
+			  {"transfer-encoding", ""},
+			  {"user-agent", ""},
+			  {"vary", ""},
+			  {"via", ""},
+			  {"www-authenticate", ""}};
+
+			struct hpack_static_ids {
+				known_header ids[hpack_static_table_size];
+			};
+
+			constexpr hpack_static_ids make_hpack_static_ids( ) noexcept {
+				hpack_static_ids result{{}};
+				for( size_t n = 0; n < hpack_static_table_size; ++n ) {
+					result.ids[n] = find_known_header( hpack_static_table[n].name );
+				}
+				return result;
+			}
+
+			// known_header of each static table name, so indexed fields skip the name lookup
+			constexpr hpack_static_ids const hpack_static_known_headers = make_hpack_static_ids( );
+
+			// RFC 7541 Appendix B, the code of each symbol right aligned.  Symbol 256 is EOS
+			constexpr size_t const hpack_huffman_symbols = 257;
+			constexpr size_t const hpack_eos = 256;
+			constexpr uint32_t const hpack_huffman_codes[hpack_huffman_symbols] = {
+			  0x1ff8, 0x7fffd8, 0xfffffe2, 0xfffffe3, 0xfffffe4, 0xfffffe5,
+			  0xfffffe6, 0xfffffe7, 0xfffffe8, 0xffffea, 0x3ffffffc, 0xfffffe9,
+			  0xfffffea, 0x3ffffffd, 0xfffffeb, 0xfffffec, 0xfffffed, 0xfffffee,
+			  0xfffffef, 0xffffff0, 0xffffff1, 0xffffff2, 0x3ffffffe, 0xffffff3,
+			  0xffffff4, 0xffffff5, 0xffffff6, 0xffffff7, 0xffffff8, 0xffffff9,
+			  0xffffffa, 0xffffffb, 0x14, 0x3f8, 0x3f9, 0xffa,
+			  0x1ff9, 0x15, 0xf8, 0x7fa, 0x3fa, 0x3fb,
+			  0xf9, 0x7fb, 0xfa, 0x16, 0x17, 0x18,
+			  0x0, 0x1, 0x2, 0x19, 0x1a, 0x1b,
+			  0x1c, 0x1d, 0x1e, 0x1f, 0x5c, 0xfb,
+			  0x7ffc, 0x20, 0xffb, 0x3fc, 0x1ffa, 0x21,
+			  0x5d, 0x5e, 0x5f, 0x60, 0x61, 0x62,
+			  0x63, 0x64, 0x65, 0x66, 0x67, 0x68,
+			  0x69, 0x6a, 0x6b, 0x6c, 0x6d, 0x6e,
+			  0x6f, 0x70, 0x71, 0x72, 0xfc, 0x73,
+			  0xfd, 0x1ffb, 0x7fff0, 0x1ffc, 0x3ffc, 0x22,
+			  0x7ffd, 0x3, 0x23, 0x4, 0x24, 0x5,
+			  0x25, 0x26, 0x27, 0x6, 0x74, 0x75,
+			  0x28, 0x29, 0x2a, 0x7, 0x2b, 0x76,
+			  0x2c, 0x8, 0x9, 0x2d, 0x77, 0x78,
+			  0x79, 0x7a, 0x7b, 0x7ffe, 0x7fc, 0x3ffd,
+			  0x1ffd, 0xffffffc, 0xfffe6, 0x3fffd2, 0xfffe7, 0xfffe8,
+			  0x3fffd3, 0x3fffd4, 0x3fffd5, 0x7fffd9, 0x3fffd6, 0x7fffda,
+			  0x7fffdb, 0x7fffdc, 0x7fffdd, 0x7fffde, 0xffffeb, 0x7fffdf,
+			  0xffffec, 0xffffed, 0x3fffd7, 0x7fffe0, 0xffffee, 0x7fffe1,
+			  0x7fffe2, 0x7fffe3, 0x7fffe4, 0x1fffdc, 0x3fffd8, 0x7fffe5,
+			  0x3fffd9, 0x7fffe6, 0x7fffe7, 0xffffef, 0x3fffda, 0x1fffdd,
+			  0xfffe9, 0x3fffdb, 0x3fffdc, 0x7fffe8, 0x7fffe9, 0x1fffde,
+			  0x7fffea, 0x3fffdd, 0x3fffde, 0xfffff0, 0x1fffdf, 0x3fffdf,
+			  0x7fffeb, 0x7fffec, 0x1fffe0, 0x1fffe1, 0x3fffe0, 0x1fffe2,
+			  0x7fffed, 0x3fffe1, 0x7fffee, 0x7fffef, 0xfffea, 0x3fffe2,
+			  0x3fffe3, 0x3fffe4, 0x7ffff0, 0x3fffe5, 0x3fffe6, 0x7ffff1,
+			  0x3ffffe0, 0x3ffffe1, 0xfffeb, 0x7fff1, 0x3fffe7, 0x7ffff2,
+			  0x3fffe8, 0x1ffffec, 0x3ffffe2, 0x3ffffe3, 0x3ffffe4, 0x7ffffde,
+			  0x7ffffdf, 0x3ffffe5, 0xfffff1, 0x1ffffed, 0x7fff2, 0x1fffe3,
+			  0x3ffffe6, 0x7ffffe0, 0x7ffffe1, 0x3ffffe7, 0x7ffffe2, 0xfffff2,
+			  0x1fffe4, 0x1fffe5, 0x3ffffe8, 0x3ffffe9, 0xffffffd, 0x7ffffe3,
+			  0x7ffffe4, 0x7ffffe5, 0xfffec, 0xfffff3, 0xfffed, 0x1fffe6,
+			  0x3fffe9, 0x1fffe7, 0x1fffe8, 0x7ffff3, 0x3fffea, 0x3fffeb,
+			  0x1ffffee, 0x1ffffef, 0xfffff4, 0xfffff5, 0x3ffffea, 0x7ffff4,
+			  0x3ffffeb, 0x7ffffe6, 0x3ffffec, 0x3ffffed, 0x7ffffe7, 0x7ffffe8,
+			  0x7ffffe9, 0x7ffffea, 0x7ffffeb, 0xffffffe, 0x7ffffec, 0x7ffffed,
+			  0x7ffffee, 0x7ffffef, 0x7fffff0, 0x3ffffee, 0x3fffffff
+			};
+			constexpr uint8_t const hpack_huffman_code_sizes[hpack_huffman_symbols] = {
+			  13, 23, 28, 28, 28, 28, 28, 28, 28, 24, 30, 28, 28, 30, 28, 28, 28, 28, 28, 28, 28, 28, 30, 28,
+			  28, 28, 28, 28, 28, 28, 28, 28, 6, 10, 10, 12, 13, 6, 8, 11, 10, 10, 8, 11, 8, 6, 6, 6,
+			  5, 5, 5, 6, 6, 6, 6, 6, 6, 6, 7, 8, 15, 6, 12, 10, 13, 6, 7, 7, 7, 7, 7, 7,
+			  7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 8, 7, 8, 13, 19, 13, 14, 6,
+			  15, 5, 6, 5, 6, 5, 6, 6, 6, 5, 7, 7, 6, 6, 6, 5, 6, 7, 6, 5, 5, 6, 7, 7,
+			  7, 7, 7, 15, 11, 14, 13, 28, 20, 22, 20, 20, 22, 22, 22, 23, 22, 23, 23, 23, 23, 23, 24, 23,
+			  24, 24, 22, 23, 24, 23, 23, 23, 23, 21, 22, 23, 22, 23, 23, 24, 22, 21, 20, 22, 22, 23, 23, 21,
+			  23, 22, 22, 24, 21, 22, 23, 23, 21, 21, 22, 21, 23, 22, 23, 23, 20, 22, 22, 22, 23, 22, 22, 23,
+			  26, 26, 20, 19, 22, 23, 22, 25, 26, 26, 26, 27, 27, 26, 24, 25, 19, 21, 26, 27, 27, 26, 27, 24,
+			  21, 21, 26, 26, 28, 27, 27, 27, 20, 24, 20, 21, 22, 21, 21, 23, 22, 22, 25, 25, 24, 24, 26, 23,
+			  26, 27, 26, 26, 27, 27, 27, 27, 27, 28, 27, 27, 27, 27, 27, 26, 30
+			};
+
+			// Decoding takes 4 bits at a time.  A state is an internal node of the code tree, 256 of them for 257
+			// leaves, and the shortest code is 5 bits so a nibble completes at most one symbol
+			struct hpack_huffman_transition {
+				uint8_t next;
+				uint8_t symbol;
+				uint8_t flags;
+			};
+
+			constexpr uint8_t const hpack_huffman_emit = 1;
+			constexpr uint8_t const hpack_huffman_fail = 2;
+			constexpr size_t const hpack_huffman_states = 256;
+
+			struct hpack_huffman_decode_table {
+				hpack_huffman_transition transitions[hpack_huffman_states][16];
+				// The bits since the last symbol are a valid padding, up to 7 bits of the EOS code
+				bool accepting[hpack_huffman_states];
+			};
+
+			constexpr hpack_huffman_decode_table make_hpack_huffman_decode_table( ) noexcept {
+				// >0 is an internal node, <0 is the leaf -( symbol + 1 ), 0 is unset as the root is nobody's child
+				int16_t children[hpack_huffman_states][2] = {};
+				int16_t node_count = 1;
+				for( size_t symbol = 0; symbol < hpack_huffman_symbols; ++symbol ) {
+					auto const code = hpack_huffman_codes[symbol];
+					size_t node = 0;
+					for( size_t bit = hpack_huffman_code_sizes[symbol] - 1; bit > 0; --bit ) {
+						auto &child = children[node][( code >> bit ) & 1U];
+						if( child == 0 ) {
+							child = node_count++;
+						}
+						node = static_cast<size_t>( child );
+					}
+					children[node][code & 1U] = static_cast<int16_t>( -static_cast<int16_t>( symbol ) - 1 );
+				}
+
+				hpack_huffman_decode_table result{{}, {}};
+				for( size_t state = 0; state < hpack_huffman_states; ++state ) {
+					for( size_t nibble = 0; nibble < 16; ++nibble ) {
+						hpack_huffman_transition transition{0, 0, 0};
+						size_t node = state;
+						for( size_t bit = 4; bit > 0; --bit ) {
+							auto const child = children[node][( nibble >> ( bit - 1 ) ) & 1U];
+							if( child >= 0 ) {
+								node = static_cast<size_t>( child );
+								continue;
+							}
+							auto const symbol = static_cast<size_t>( -child - 1 );
+							if( symbol == hpack_eos ) {
+								transition.flags |= hpack_huffman_fail;
+								break;
+							}
+							transition.symbol = static_cast<uint8_t>( symbol );
+							transition.flags |= hpack_huffman_emit;
+							node = 0;
+						}
+						transition.next = static_cast<uint8_t>( node );
+						result.transitions[state][nibble] = transition;
+					}
+				}
+				size_t node = 0;
+				result.accepting[0] = true;
+				for( size_t depth = 1; depth < 8; ++depth ) {
+					node = static_cast<size_t>( children[node][1] );
+					result.accepting[node] = true;
+				}
+				return result;
+			}
+
+			constexpr hpack_huffman_decode_table const hpack_huffman_decoder = make_hpack_huffman_decode_table( );
+
+			// Decode the Huffman coded str into out, returns the number of characters written.  Padding longer than
+			// 7 bits, padding that is not a prefix of EOS and an encoded EOS are errors
+			inline size_t hpack_huffman_decode( daw::string_view const str, char *out, size_t const out_size ) {
+				size_t count = 0;
+				size_t state = 0;
+				for( auto const c : str ) {
+					auto const byte = static_cast<uint8_t>( c );
+					for( size_t shift = 8; shift > 0; shift -= 4 ) {
+						auto const &transition = hpack_huffman_decoder.transitions[state][( byte >> ( shift - 4 ) ) & 0xFU];
+						if( transition.flags & hpack_huffman_fail ) {
+							throw hpack_compression_exception{};
+						}
+						if( transition.flags & hpack_huffman_emit ) {
+							if( count == out_size ) {
+								throw http_limit_exceeded_exception{};
+							}
+							out[count++] = static_cast<char>( transition.symbol );
+						}
+						state = transition.next;
+					}
+				}
+				if( !hpack_huffman_decoder.accepting[state] ) {
+					throw hpack_compression_exception{};
+				}
+				return count;
+			}
+
+			// RFC 7541 5.1 integer with a prefix_bits prefix, removed from the front of str.  Values that do not fit
+			// in 32bits are refused
+			constexpr uint32_t hpack_decode_integer( daw::string_view &str, size_t const prefix_bits ) {
+				if( str.empty( ) ) {
+					throw hpack_compression_exception{};
+				}
+				uint32_t const prefix_max = ( 1U << prefix_bits ) - 1;
+				uint64_t value = static_cast<uint8_t>( str.front( ) ) & prefix_max;
+				str.remove_prefix( );
+				if( value < prefix_max ) {
+					return static_cast<uint32_t>( value );
+				}
+				for( size_t shift = 0; shift <= 28; shift += 7 ) {
+					if( str.empty( ) ) {
+						throw hpack_compression_exception{};
+					}
+					auto const byte = static_cast<uint8_t>( str.front( ) );
+					str.remove_prefix( );
+					value += static_cast<uint64_t>( byte & 0x7FU ) << shift;
+					if( ( byte & 0x80U ) == 0 ) {
+						if( value > 0xFFFF'FFFFULL ) {
+							break;
+						}
+						return static_cast<uint32_t>( value );
+					}
+				}
+				throw hpack_compression_exception{};
+			}
+
+			// Field names in HTTP/2 are lower case tokens
+			constexpr bool is_hpack_field_name( daw::string_view const name ) noexcept {
+				if( name.empty( ) ) {
+					return false;
+				}
+				for( size_t pos = name.front( ) == ':' ? 1 : 0; pos < name.size( ); pos += 8 ) {
+					auto const count = name.size( ) - pos;
+					uint64_t const word = daw::swar::load( name.data( ) + pos, count, 'a' );
+					uint64_t const invalid = ~daw::swar::bytes_between( word, 0x21, 0x7E ) |
+					                         daw::swar::bytes_between( word, 'A', 'Z' ) | daw::swar::bytes_equal( word, ':' );
+					if( ( invalid & daw::swar::hi_bits ) != 0 ) {
+						return false;
+					}
+				}
+				return true;
+			}
+
+			struct hpack_pseudo_headers {
+				daw::string_view method;
+				daw::string_view scheme;
+				daw::string_view authority;
+				daw::string_view path;
+				uint8_t seen;
+			};
+		} // namespace impl
+
+		// Decoder for the header blocks of one HTTP/2 connection.  The request pseudo-headers are turned straight into
+		// an http_request and the other fields go into an http_header_index, as if an HTTP/1.1 head had been parsed.
+		// :authority is also added as a Host header when there is none, and cookie fields, which HTTP/2 clients send
+		// one per cookie( RFC 9113 8.2.3 ), are joined with "; " into one Cookie header.
+		//
+		// TableCapacity is the largest SETTINGS_HEADER_TABLE_SIZE that will be advertised, the dynamic table lives
+		// in a ring buffer of that many bytes.  Huffman coded strings, fields taken from the dynamic table and joined
+		// cookies are copied to a BufferSize scratch buffer, other literals are views into the block.  The views are
+		// valid until the next decode and while the block is.  Nothing is allocated
+		template<size_t TableCapacity = 4096, size_t BufferSize = 16 * 1024>
+		struct basic_hpack_decoder {
+			static_assert( TableCapacity >= 32, "A dynamic table entry takes at least 32 octets" );
+
+			// The peer's default before any SETTINGS are acknowledged
+			static constexpr size_t const default_table_size = TableCapacity < 4096 ? TableCapacity : 4096;
+
+		private:
+			struct table_entry {
+				size_t offset;
+				size_t name_size;
+				size_t value_size;
+				known_header id;
+			};
+			static constexpr size_t const max_entries = TableCapacity / 32;
+
+			char m_table_bytes[TableCapacity];
+			table_entry m_entries[max_entries];
+			size_t m_oldest;      // position in m_entries of the oldest entry
+			size_t m_entry_count;
+			size_t m_table_head;  // where the next entry's bytes go in m_table_bytes
+			size_t m_table_size;  // RFC 7541 4.1 size, the octets plus 32 per entry
+			size_t m_max_table_size;
+			size_t m_table_size_limit;
+			bool m_resize_pending;
+			char m_buffer[BufferSize];
+			size_t m_buffer_used;
+			http_limits m_limits;
+
+			table_entry const &dynamic_entry( size_t const index ) const noexcept {
+				// dynamic index 0 is the newest entry
+				return m_entries[( m_oldest + m_entry_count - 1 - index ) % max_entries];
+			}
+
+			void evict_oldest( ) noexcept {
+				auto const &oldest = m_entries[m_oldest];
+				m_table_size -= oldest.name_size + oldest.value_size + 32;
+				m_oldest = ( m_oldest + 1 ) % max_entries;
+				--m_entry_count;
+			}
+
+			void evict_to( size_t const size ) noexcept {
+				while( m_table_size > size ) {
+					evict_oldest( );
+				}
+			}
+
+			void copy_to_table( daw::string_view const str ) noexcept {
+				auto const first = str.size( ) < TableCapacity - m_table_head ? str.size( ) : TableCapacity - m_table_head;
+				std::memcpy( m_table_bytes + m_table_head, str.data( ), first );
+				std::memcpy( m_table_bytes, str.data( ) + first, str.size( ) - first );
+				m_table_head = ( m_table_head + str.size( ) ) % TableCapacity;
+			}
+
+			// RFC 7541 4.4, an entry larger than the table empties it and is not added
+			void insert( http_header const &field ) noexcept {
+				auto const size = field.name.size( ) + field.value.size( ) + 32;
+				if( size > m_max_table_size ) {
+					evict_to( 0 );
+					return;
+				}
+				evict_to( m_max_table_size - size );
+				// The live octets are at most m_max_table_size - 32 * entries, so this never overwrites them
+				auto const offset = m_table_head;
+				copy_to_table( field.name );
+				copy_to_table( field.value );
+				m_entries[( m_oldest + m_entry_count ) % max_entries] =
+				  table_entry{offset, field.name.size( ), field.value.size( ), field.id};
+				++m_entry_count;
+				m_table_size += size;
+			}
+
+			char *reserve( size_t const size ) {
+				if( size > BufferSize - m_buffer_used ) {
+					throw http_limit_exceeded_exception{};
+				}
+				auto result = m_buffer + m_buffer_used;
+				m_buffer_used += size;
+				return result;
+			}
+
+			daw::string_view copy_from_table( size_t offset, size_t const size ) {
+				auto out = reserve( size );
+				offset %= TableCapacity;
+				auto const first = size < TableCapacity - offset ? size : TableCapacity - offset;
+				std::memcpy( out, m_table_bytes + offset, first );
+				std::memcpy( out + first, m_table_bytes, size - first );
+				return daw::string_view{out, size};
+			}
+
+			// Field at an HPACK index, the value is only looked up when with_value is true
+			http_header lookup( size_t index, bool const with_value ) {
+				if( index == 0 ) {
+					throw hpack_compression_exception{};
+				}
+				--index;
+				if( index < impl::hpack_static_table_size ) {
+					auto const &entry = impl::hpack_static_table[index];
+					return http_header{entry.name, with_value ? entry.value : daw::string_view{},
+					                   impl::hpack_static_known_headers.ids[index]};
+				}
+				index -= impl::hpack_static_table_size;
+				if( index >= m_entry_count ) {
+					throw hpack_compression_exception{};
+				}
+				auto const &entry = dynamic_entry( index );
+				http_header result{copy_from_table( entry.offset, entry.name_size ), daw::string_view{}, entry.id};
+				if( with_value ) {
+					result.value = copy_from_table( entry.offset + entry.name_size, entry.value_size );
+				}
+				return result;
+			}
+
+			daw::string_view read_string( daw::string_view &block ) {
+				if( block.empty( ) ) {
+					throw hpack_compression_exception{};
+				}
+				bool const huffman = ( static_cast<uint8_t>( block.front( ) ) & 0x80U ) != 0;
+				auto const size = impl::hpack_decode_integer( block, 7 );
+				if( size > block.size( ) ) {
+					throw hpack_compression_exception{};
+				}
+				auto const encoded = block.substr( 0, size );
+				block.remove_prefix( size );
+				if( !huffman ) {
+					return encoded;
+				}
+				auto out = m_buffer + m_buffer_used;
+				auto const decoded_size = impl::hpack_huffman_decode( encoded, out, BufferSize - m_buffer_used );
+				m_buffer_used += decoded_size;
+				return daw::string_view{out, decoded_size};
+			}
+
+			// Literal field with the name index in the low prefix_bits of the first octet
+			http_header read_literal( daw::string_view &block, size_t const prefix_bits ) {
+				auto const name_index = impl::hpack_decode_integer( block, prefix_bits );
+				http_header result{};
+				if( name_index == 0 ) {
+					result.name = read_string( block );
+					result.id = find_known_header( result.name );
+				} else {
+					result = lookup( name_index, false );
+				}
+				result.value = read_string( block );
+				return result;
+			}
+
+		public:
+			explicit basic_hpack_decoder( http_limits const &limits = http_limits{} ) noexcept
+			  : m_table_bytes{}
+			  , m_entries{}
+			  , m_oldest{0}
+			  , m_entry_count{0}
+			  , m_table_head{0}
+			  , m_table_size{0}
+			  , m_max_table_size{default_table_size}
+			  , m_table_size_limit{default_table_size}
+			  , m_resize_pending{false}
+			  , m_buffer{}
+			  , m_buffer_used{0}
+			  , m_limits{limits} {}
+
+			basic_hpack_decoder( basic_hpack_decoder const & ) = delete;
+			basic_hpack_decoder &operator=( basic_hpack_decoder const & ) = delete;
+
+			// The SETTINGS_HEADER_TABLE_SIZE we sent was acknowledged.  The peer must then start its next block with
+			// a size update no larger than size
+			void set_table_size_limit( size_t const size ) {
+				if( size > TableCapacity ) {
+					throw http_limit_exceeded_exception{};
+				}
+				m_table_size_limit = size;
+				if( m_max_table_size > size ) {
+					m_resize_pending = true;
+				}
+			}
+
+			size_t table_size( ) const noexcept {
+				return m_table_size;
+			}
+
+			size_t max_table_size( ) const noexcept {
+				return m_max_table_size;
+			}
+
+			size_t table_entries( ) const noexcept {
+				return m_entry_count;
+			}
+
+			// Decode one complete header block, i.e. HEADERS plus any CONTINUATION frames.  A malformed request or one
+			// over the limits throws only after the whole block is decoded, so the dynamic table stays usable.
+			// hpack_compression_exception and running out of scratch space are not recoverable
+			void decode( daw::string_view block, http_request &request, http_header_index &headers ) {
+				headers.clear( );
+				m_buffer_used = 0;
+				impl::hpack_pseudo_headers pseudo{{}, {}, {}, {}, 0};
+				bool malformed = false;
+				bool over_limit = false;
+				bool regular_seen = false;
+				bool at_start = true;
+				size_t header_bytes = 0;
+				daw::string_view cookies[http_header_index::capacity];
+				size_t cookie_count = 0;
+
+				while( !block.empty( ) ) {
+					auto const first = static_cast<uint8_t>( block.front( ) );
+					http_header field{};
+					if( first & 0x80U ) {
+						field = lookup( impl::hpack_decode_integer( block, 7 ), true );
+					} else if( first & 0x40U ) {
+						field = read_literal( block, 6 );
+						insert( field );
+					} else if( first & 0x20U ) {
+						// RFC 7541 4.2, only before the first field of a block
+						auto const size = impl::hpack_decode_integer( block, 5 );
+						if( !at_start || size > m_table_size_limit ) {
+							throw hpack_compression_exception{};
+						}
+						m_max_table_size = size;
+						m_resize_pending = false;
+						evict_to( size );
+						continue;
+					} else {
+						// without indexing and never indexed only differ for intermediaries that re-encode
+						field = read_literal( block, 4 );
+					}
+					if( m_resize_pending ) {
+						throw hpack_compression_exception{};
+					}
+					at_start = false;
+
+					if( !impl::is_hpack_field_name( field.name ) ) {
+						malformed = true;
+						continue;
+					}
+					if( field.name.front( ) == ':' ) {
+						daw::string_view *target = nullptr;
+						uint8_t bit = 0;
+						if( field.name == ":method" ) {
+							target = &pseudo.method;
+							bit = 1;
+						} else if( field.name == ":scheme" ) {
+							target = &pseudo.scheme;
+							bit = 2;
+						} else if( field.name == ":authority" ) {
+							target = &pseudo.authority;
+							bit = 4;
+						} else if( field.name == ":path" ) {
+							target = &pseudo.path;
+							bit = 8;
+						}
+						if( target == nullptr || regular_seen || ( pseudo.seen & bit ) != 0 ) {
+							malformed = true;
+							continue;
+						}
+						pseudo.seen |= bit;
+						*target = field.value;
+						continue;
+					}
+					regular_seen = true;
+					// RFC 9113 8.2.2, connection specific fields are not allowed
+					switch( field.id ) {
+					case known_header::connection:
+					case known_header::keep_alive:
+					case known_header::transfer_encoding:
+					case known_header::upgrade:
+						malformed = true;
+						continue;
+					case known_header::te:
+						if( field.value != "trailers" ) {
+							malformed = true;
+							continue;
+						}
+						break;
+					default:
+						break;
+					}
+					header_bytes += field.name.size( ) + field.value.size( ) + 32;
+					// all cookie fields share the slot of the first one
+					bool const joined = field.id == known_header::cookie && cookie_count != 0;
+					size_t const slots = headers.size( ) + ( cookie_count != 0 ? 1 : 0 );
+					if( ( !joined && slots >= max_header_count( m_limits ) ) ||
+					    cookie_count == http_header_index::capacity || header_bytes > m_limits.max_header_bytes ) {
+						over_limit = true;
+						continue;
+					}
+					if( field.id == known_header::cookie ) {
+						cookies[cookie_count++] = field.value;
+						continue;
+					}
+					headers.push_back( field );
+				}
+				if( m_resize_pending ) {
+					throw hpack_compression_exception{};
+				}
+				if( over_limit || pseudo.path.size( ) > m_limits.max_request_line ) {
+					throw http_limit_exceeded_exception{};
+				}
+				if( malformed || pseudo.method.empty( ) ) {
+					throw daw::parser::invalid_input_exception{};
+				}
+				if( cookie_count == 1 ) {
+					headers.push_back( http_header{"cookie", cookies[0], known_header::cookie} );
+				} else if( cookie_count > 1 ) {
+					size_t size = 2 * ( cookie_count - 1 );
+					for( size_t n = 0; n < cookie_count; ++n ) {
+						size += cookies[n].size( );
+					}
+					auto const out = reserve( size );
+					size_t pos = 0;
+					for( size_t n = 0; n < cookie_count; ++n ) {
+						if( n != 0 ) {
+							out[pos++] = ';';
+							out[pos++] = ' ';
+						}
+						std::memcpy( out + pos, cookies[n].data( ), cookies[n].size( ) );
+						pos += cookies[n].size( );
+					}
+					headers.push_back( http_header{"cookie", daw::string_view{out, size}, known_header::cookie} );
+				}
+				request = http_request{};
+				request.method = parse_to_value( pseudo.method, request_method{} );
+				request.version = http_version{0, 2};
+				if( request.method == request_method::CONNECT ) {
+					// RFC 9113 8.5, only :authority
+					if( pseudo.seen != ( 1 | 4 ) ) {
+						throw daw::parser::invalid_input_exception{};
+					}
+				} else {
+					if( ( pseudo.seen & ( 2 | 8 ) ) != ( 2 | 8 ) || pseudo.scheme.empty( ) ) {
+						throw daw::parser::invalid_input_exception{};
+					}
+					if( pseudo.path == "*" && request.method == request_method::OPTIONS ) {
+						request.uri.path = pseudo.path;
+					} else if( pseudo.path.empty( ) || pseudo.path.front( ) != '/' ) {
+						throw daw::parser::invalid_input_exception{};
+					} else {
+						request.uri = parse_to_value( pseudo.path, http_uri{} );
+					}
+					request.uri.scheme = pseudo.scheme;
+				}
+				if( !pseudo.authority.empty( ) ) {
+					// RFC 9113 8.3.1, no userinfo
+					if( pseudo.authority.find( '@' ) != daw::string_view::npos ) {
+						throw daw::parser::invalid_input_exception{};
+					}
+					auto authority = pseudo.authority;
+					auto const host_info = impl::parse_hostinfo( authority, true );
+					if( !authority.empty( ) ) {
+						throw daw::parser::invalid_input_exception{};
+					}
+					request.uri.host = host_info.hostname;
+					request.uri.address = host_info.address;
+					request.uri.port = host_info.port;
+					if( !headers.contains( known_header::host ) ) {
+						if( headers.size( ) >= max_header_count( m_limits ) ) {
+							throw http_limit_exceeded_exception{};
+						}
+						headers.push_back( http_header{"host", pseudo.authority, known_header::host} );
+					}
+				}
+				request.headers_present = headers.present( );
+			}
+		};
+
+		using hpack_decoder = basic_hpack_decoder<>;
+	} // namespace http
+} // namespace daw
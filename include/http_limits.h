@@ -0,0 +1,50 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2017 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstddef>
+
+#include <daw/daw_parser_helper.h>
+
+namespace daw {
+	namespace http {
+		// Thrown when a message is larger than the http_limits in use.  It is invalid input, so existing handlers
+		// still catch it
+		struct http_limit_exceeded_exception : daw::parser::invalid_input_exception {};
+
+		// Upper bounds on the parts of a request head.  They are checked while the input is scanned, so parsing stops
+		// at the first character past a limit instead of after the whole input has been looked at
+		struct http_limits {
+			// Characters in the request line, not counting the CRLF
+			size_t max_request_line = 8 * 1024;
+			// Characters in the method, request target path, query, fragment or version
+			size_t max_uri_component = 4 * 1024;
+			// Number of '%' in the request line
+			size_t max_percent_escapes = 512;
+			// Number of header lines.  More than http_header_index::capacity count as that, see max_header_count
+			size_t max_headers = 64;
+			// Characters in the header lines including the empty line ending them
+			size_t max_header_bytes = 32 * 1024;
+		};
+	} // namespace http
+} // namespace daw
@@ -0,0 +1,317 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2017 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <utility>
+
+#include <daw/daw_parser_helper.h>
+#include <daw/daw_string_view.h>
+
+#include "daw_swar.h"
+#include "http_headers.h"
+#include "http_limits.h"
+
+namespace daw {
+	namespace http {
+		namespace impl {
+			constexpr bool is_boundary_char( char const c ) noexcept {
+				return 0x20 <= c && c <= 0x7E && c != '"';
+			}
+		} // namespace impl
+
+		// The boundary parameter of a multipart Content-Type value, without quotes.  Empty when there is none
+		constexpr daw::string_view find_multipart_boundary( daw::string_view const content_type ) noexcept {
+			size_t pos = 0;
+			while( pos < content_type.size( ) ) {
+				auto const semi = daw::swar::find( content_type, ';', pos );
+				if( semi == daw::string_view::npos ) {
+					break;
+				}
+				auto param = impl::trim_ows( content_type.substr( semi + 1 ) );
+				pos = semi + 1;
+				if( param.size( ) < 9 || !impl::equal_ignore_case( param.substr( 0, 9 ), "boundary=" ) ) {
+					continue;
+				}
+				param.remove_prefix( 9 );
+				if( !param.empty( ) && param.front( ) == '"' ) {
+					param.remove_prefix( );
+					return param.substr( 0, param.find( '"' ) );
+				}
+				return impl::trim_ows( param.substr( 0, param.find( ';' ) ) );
+			}
+			return daw::string_view{};
+		}
+
+		// Splits a multipart body that arrives in chunks.  The delimiter is found by checking the first and last
+		// character of every candidate position 8 at a time and comparing the rest only where both match.  Part
+		// headers are parsed with parse_headers.  Handler needs
+		//   part_begin( http_header_index const & )
+		//   part_data( daw::string_view )
+		//   part_end( )
+		// Part data is passed as views into the chunk.  Only the few characters at the end of a chunk that could be
+		// the start of a delimiter are held back and copied, and part headers that straddle chunks are collected in a
+		// buffer of HeaderSize characters.  The views passed to the handler are only valid during the call
+		template<typename Handler, size_t HeaderSize = 4 * 1024>
+		struct basic_http_multipart_parser {
+			static constexpr size_t const max_boundary_size = 70;
+
+		private:
+			static constexpr size_t const max_delimiter_size = max_boundary_size + 4;
+
+			enum class state_t : uint_fast8_t { body, boundary_end, boundary_dash, boundary_lf, headers, done };
+
+			Handler m_handler;
+			char m_delimiter[max_delimiter_size];
+			size_t m_delimiter_size;
+			// characters that may be the start of a delimiter, with room to append as much of the next chunk
+			char m_held[2 * max_delimiter_size];
+			size_t m_held_size;
+			char m_header_buffer[HeaderSize];
+			size_t m_header_size;
+			http_header_index m_headers;
+			state_t m_state;
+			bool m_in_part;
+
+			daw::string_view delimiter( ) const noexcept {
+				return daw::string_view{m_delimiter, m_delimiter_size};
+			}
+
+			void data( daw::string_view const str ) {
+				if( m_in_part && !str.empty( ) ) {
+					m_handler.part_data( str );
+				}
+			}
+
+			// Position of the first delimiter in str, npos when there is none
+			size_t find_delimiter( daw::string_view const str ) const noexcept {
+				if( str.size( ) < m_delimiter_size ) {
+					return daw::string_view::npos;
+				}
+				auto const last_char = static_cast<uint8_t>( m_delimiter[m_delimiter_size - 1] );
+				size_t const candidates = str.size( ) - m_delimiter_size + 1;
+				for( size_t pos = 0; pos < candidates; pos += 8 ) {
+					size_t const count = candidates - pos < 8 ? candidates - pos : 8;
+					uint64_t matches = daw::swar::bytes_equal( daw::swar::load( str.data( ) + pos, count ), '\r' ) &
+					                   daw::swar::bytes_equal(
+					                     daw::swar::load( str.data( ) + pos + m_delimiter_size - 1, count ), last_char ) &
+					                   daw::swar::prefix_mask( count );
+					while( matches != 0 ) {
+						size_t const idx = pos + daw::swar::first_set_byte( matches );
+						if( std::memcmp( str.data( ) + idx, m_delimiter, m_delimiter_size ) == 0 ) {
+							return idx;
+						}
+						matches &= matches - 1;
+					}
+				}
+				return daw::string_view::npos;
+			}
+
+			// Size of the longest end of str that is the start of a delimiter
+			size_t partial_delimiter( daw::string_view const str ) const noexcept {
+				size_t pos = str.size( ) >= m_delimiter_size ? str.size( ) - ( m_delimiter_size - 1 ) : 0;
+				for( ; pos < str.size( ); ++pos ) {
+					if( str[pos] == '\r' && std::memcmp( str.data( ) + pos, m_delimiter, str.size( ) - pos ) == 0 ) {
+						return str.size( ) - pos;
+					}
+				}
+				return 0;
+			}
+
+			void delimiter_found( ) {
+				if( m_in_part ) {
+					m_handler.part_end( );
+					m_in_part = false;
+				}
+				m_state = state_t::boundary_end;
+			}
+
+			// Part data up to the next delimiter.  Returns the part of chunk after it
+			daw::string_view scan_body( daw::string_view chunk ) {
+				if( m_held_size != 0 ) {
+					size_t const held = m_held_size;
+					size_t const appended = chunk.size( ) < m_delimiter_size ? chunk.size( ) : m_delimiter_size;
+					std::memcpy( m_held + held, chunk.data( ), appended );
+					auto const joined = daw::string_view{m_held, held + appended};
+					auto const found = find_delimiter( joined );
+					if( found != daw::string_view::npos && found < held ) {
+						m_held_size = 0;
+						data( joined.substr( 0, found ) );
+						delimiter_found( );
+						chunk.remove_prefix( found + m_delimiter_size - held );
+						return chunk;
+					}
+					if( appended == chunk.size( ) && found == daw::string_view::npos ) {
+						// all of chunk was joined and may still end in the start of a delimiter
+						size_t const partial = partial_delimiter( joined );
+						m_held_size = 0;
+						data( joined.substr( 0, joined.size( ) - partial ) );
+						std::memmove( m_held, m_held + joined.size( ) - partial, partial );
+						m_held_size = partial;
+						return daw::string_view{};
+					}
+					// No delimiter starts in the held characters
+					m_held_size = 0;
+					data( joined.substr( 0, held ) );
+				}
+				auto const found = find_delimiter( chunk );
+				if( found != daw::string_view::npos ) {
+					data( chunk.substr( 0, found ) );
+					delimiter_found( );
+					chunk.remove_prefix( found + m_delimiter_size );
+					return chunk;
+				}
+				size_t const partial = partial_delimiter( chunk );
+				data( chunk.substr( 0, chunk.size( ) - partial ) );
+				std::memcpy( m_held, chunk.data( ) + chunk.size( ) - partial, partial );
+				m_held_size = partial;
+				return daw::string_view{};
+			}
+
+			daw::string_view scan_headers( daw::string_view chunk ) {
+				if( m_header_size == 0 ) {
+					auto const size = parse_headers( chunk, m_headers );
+					if( size != 0 ) {
+						begin_part( );
+						chunk.remove_prefix( size );
+						return chunk;
+					}
+				}
+				size_t const old_size = m_header_size;
+				size_t const appended = chunk.size( ) < HeaderSize - old_size ? chunk.size( ) : HeaderSize - old_size;
+				std::memcpy( m_header_buffer + old_size, chunk.data( ), appended );
+				m_header_size += appended;
+				auto const size = parse_headers( daw::string_view{m_header_buffer, m_header_size}, m_headers );
+				if( size != 0 ) {
+					begin_part( );
+					m_header_size = 0;
+					chunk.remove_prefix( size - old_size );
+					return chunk;
+				}
+				if( m_header_size == HeaderSize ) {
+					throw http_limit_exceeded_exception{};
+				}
+				return daw::string_view{};
+			}
+
+			void begin_part( ) {
+				m_state = state_t::body;
+				m_in_part = true;
+				m_handler.part_begin( m_headers );
+			}
+
+		public:
+			// The boundary is the parameter from the Content-Type, see find_multipart_boundary
+			basic_http_multipart_parser( daw::string_view const boundary, Handler handler )
+			  : m_handler{std::move( handler )}
+			  , m_delimiter{}
+			  , m_delimiter_size{boundary.size( ) + 4}
+			  , m_held{}
+			  , m_held_size{2}
+			  , m_header_buffer{}
+			  , m_header_size{0}
+			  , m_headers{}
+			  , m_state{state_t::body}
+			  , m_in_part{false} {
+
+				if( boundary.empty( ) || boundary.size( ) > max_boundary_size || boundary.back( ) == ' ' ) {
+					throw daw::parser::invalid_input_exception{};
+				}
+				for( auto const c : boundary ) {
+					if( !impl::is_boundary_char( c ) ) {
+						throw daw::parser::invalid_input_exception{};
+					}
+				}
+				std::memcpy( m_delimiter, "\r\n--", 4 );
+				std::memcpy( m_delimiter + 4, boundary.data( ), boundary.size( ) );
+				// The first delimiter may be at the very start of the body, without a line end before it
+				std::memcpy( m_held, "\r\n", 2 );
+			}
+
+			basic_http_multipart_parser( basic_http_multipart_parser const & ) = delete;
+			basic_http_multipart_parser &operator=( basic_http_multipart_parser const & ) = delete;
+
+			void parse( daw::string_view chunk ) {
+				while( !chunk.empty( ) ) {
+					switch( m_state ) {
+					case state_t::body:
+						chunk = scan_body( chunk );
+						break;
+					case state_t::boundary_end:
+						// "--" ends the body, otherwise optional whitespace and CRLF start the next part
+						if( chunk.front( ) == '-' ) {
+							m_state = state_t::boundary_dash;
+						} else if( chunk.front( ) == '\r' ) {
+							m_state = state_t::boundary_lf;
+						} else if( !impl::is_ows( chunk.front( ) ) ) {
+							throw daw::parser::invalid_input_exception{};
+						}
+						chunk.remove_prefix( );
+						break;
+					case state_t::boundary_dash:
+						if( chunk.front( ) != '-' ) {
+							throw daw::parser::invalid_input_exception{};
+						}
+						m_state = state_t::done;
+						chunk.remove_prefix( );
+						break;
+					case state_t::boundary_lf:
+						if( chunk.front( ) != '\n' ) {
+							throw daw::parser::invalid_input_exception{};
+						}
+						m_state = state_t::headers;
+						chunk.remove_prefix( );
+						break;
+					case state_t::headers:
+						chunk = scan_headers( chunk );
+						break;
+					case state_t::done:
+						// the epilogue is ignored
+						return;
+					}
+				}
+			}
+
+			// true once the closing delimiter has been seen
+			bool done( ) const noexcept {
+				return m_state == state_t::done;
+			}
+
+			Handler &handler( ) noexcept {
+				return m_handler;
+			}
+
+			Handler const &handler( ) const noexcept {
+				return m_handler;
+			}
+		};
+
+		template<typename Handler>
+		auto make_http_multipart_parser( daw::string_view const boundary, Handler handler ) {
+			return std::make_unique<basic_http_multipart_parser<Handler>>( boundary, std::move( handler ) );
+		}
+	} // namespace http
+} // namespace daw
@@ -0,0 +1,113 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2017 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <daw/daw_parser_helper.h>
+#include <daw/daw_string_view.h>
+
+#include "http_headers.h"
+#include "http_limits.h"
+#include "http_req_parser.h"
+#include "http_utf8.h"
+
+namespace daw {
+	namespace http {
+		// Size of the unit the cache coherency protocol works in on the platforms targeted
+		constexpr size_t const cache_line_size = 64;
+
+		struct http_parser_counters {
+			uint64_t requests;
+			uint64_t bytes;
+			uint64_t invalid;
+			uint64_t over_limit;
+		};
+
+		// Everything one thread needs to parse requests: the parsed request, its headers, a scratch buffer for
+		// decoding and plain counters.  Nothing in it is shared, and it starts on its own cache line so the
+		// contexts of two threads never share a line.  Operator new only honours the alignment from C++17 on, so
+		// create it where it is used, e.g. on the stack of the thread function
+		template<size_t ScratchSize = 8 * 1024>
+		struct alignas( cache_line_size ) basic_http_parser_context {
+			http_request request;
+			http_header_index headers;
+			http_limits limits;
+			http_parser_counters counters;
+
+		private:
+			char m_scratch[ScratchSize];
+
+		public:
+			explicit basic_http_parser_context( http_limits const &parse_limits = http_limits{} ) noexcept
+			  : request{}, headers{}, limits{parse_limits}, counters{0, 0, 0, 0}, m_scratch{} {}
+
+			basic_http_parser_context( basic_http_parser_context const & ) = delete;
+			basic_http_parser_context &operator=( basic_http_parser_context const & ) = delete;
+
+			// parse_request_head into request and headers.  Returns the size of the head or 0 when it is not complete.
+			// Errors are counted and rethrown
+			size_t parse( daw::string_view const str ) {
+				try {
+					auto const size = parse_request_head( str, request, headers, limits );
+					if( size != 0 ) {
+						++counters.requests;
+						counters.bytes += size;
+					}
+					return size;
+				} catch( http_limit_exceeded_exception const & ) {
+					++counters.over_limit;
+					throw;
+				} catch( daw::parser::invalid_input_exception const & ) {
+					++counters.invalid;
+					throw;
+				}
+			}
+
+			// Percent decoded path of the last request, in the scratch buffer until the next call.  Throws when it is
+			// longer than the scratch buffer or is not valid UTF-8
+			daw::string_view decoded_path( ) {
+				auto const path = request.uri.path;
+				if( path.size( ) > ScratchSize ) {
+					throw http_limit_exceeded_exception{};
+				}
+				auto const result = percent_decode_utf8( path, m_scratch );
+				if( result.invalid_utf8_offset != daw::string_view::npos ) {
+					throw daw::parser::invalid_input_exception{};
+				}
+				return daw::string_view{m_scratch, result.size};
+			}
+
+			char *scratch( ) noexcept {
+				return m_scratch;
+			}
+
+			static constexpr size_t scratch_size( ) noexcept {
+				return ScratchSize;
+			}
+		};
+
+		using http_parser_context = basic_http_parser_context<>;
+	} // namespace http
+} // namespace daw
@@ -0,0 +1,273 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2017 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <daw/daw_parser_helper.h>
+#include <daw/daw_string_view.h>
+
+#include "daw_swar.h"
+#include "ip_address_parser.h"
+
+// The PROXY protocol header( v1 text and v2 binary ) that load balancers put in front of a connection's first
+// request.  https://www.haproxy.org/download/2.0/doc/proxy-protocol.txt
+namespace daw {
+	namespace http {
+		enum class proxy_protocol_prefix : uint_fast8_t {
+			none,      // the connection starts with something else, e.g. the request line
+			v1,        // "PROXY "
+			v2,        // the 12 octet binary signature
+			incomplete // too few octets yet to tell
+		};
+
+		enum class proxy_address_family : uint_fast8_t { unspecified, inet, inet6, unix_socket };
+		enum class proxy_transport : uint_fast8_t { unspecified, stream, datagram };
+
+		struct proxy_header {
+			uint_fast8_t version;
+			// LOCAL( v2 ) or UNKNOWN( v1 ), the addresses of the connection itself apply
+			bool local;
+			proxy_address_family family;
+			proxy_transport transport;
+			http_host_address source;
+			http_host_address destination;
+			uint16_t source_port;
+			uint16_t destination_port;
+			// unix_socket addresses, NUL padded as sent
+			daw::string_view source_path;
+			daw::string_view destination_path;
+			// v2 type-length-value extensions, unparsed
+			daw::string_view tlvs;
+		};
+
+		namespace impl {
+			constexpr char const proxy_v2_signature[12] = {'\r', '\n', '\r', '\n', '\0', '\r',
+			                                               '\n', 'Q',  'U',  'I',  'T',  '\n'};
+			constexpr size_t const proxy_v1_max_size = 107;
+			constexpr size_t const proxy_v2_header_size = 16;
+			constexpr size_t const proxy_unix_path_size = 108;
+
+			// The signature as a 64bit and a 32bit word, compared in two steps
+			constexpr uint64_t const proxy_v2_signature_low = daw::swar::load( proxy_v2_signature, 8 );
+			constexpr uint64_t const proxy_v2_signature_high = daw::swar::load( proxy_v2_signature + 8, 4 );
+			constexpr uint64_t const proxy_v1_signature = daw::swar::load( "PROXY ", 6 );
+
+			constexpr uint16_t get_be16( char const *ptr ) noexcept {
+				return static_cast<uint16_t>( ( static_cast<uint8_t>( ptr[0] ) << 8 ) | static_cast<uint8_t>( ptr[1] ) );
+			}
+
+			constexpr uint32_t get_be32( char const *ptr ) noexcept {
+				return ( static_cast<uint32_t>( get_be16( ptr ) ) << 16 ) | get_be16( ptr + 2 );
+			}
+
+			constexpr http_host_address make_ipv4( uint32_t const address ) noexcept {
+				return http_host_address{host_type::ipv4, address, {}};
+			}
+
+			constexpr http_host_address make_ipv6( char const *ptr ) noexcept {
+				http_host_address result{host_type::ipv6, 0, {}};
+				for( size_t n = 0; n < 16; ++n ) {
+					result.ipv6.octets[n] = static_cast<uint8_t>( ptr[n] );
+				}
+				return result;
+			}
+
+			// Split off the text before the next ' '
+			constexpr daw::string_view next_proxy_field( daw::string_view &line ) {
+				auto const end = line.find( ' ' );
+				auto const field = line.substr( 0, end );
+				if( field.empty( ) ) {
+					throw daw::parser::invalid_input_exception{};
+				}
+				line.remove_prefix( end == daw::string_view::npos ? line.size( ) : end + 1 );
+				return field;
+			}
+
+			constexpr http_host_address parse_proxy_v1_address( daw::string_view const str, bool const ipv6 ) {
+				if( ipv6 ) {
+					auto const address = parse_ipv6( str );
+					if( !address ) {
+						throw daw::parser::invalid_input_exception{};
+					}
+					http_host_address result{host_type::ipv6, 0, {}};
+					result.ipv6 = address.address;
+					return result;
+				}
+				auto const address = parse_ipv4_prefix( str );
+				if( !address || address.size != str.size( ) ) {
+					throw daw::parser::invalid_input_exception{};
+				}
+				return make_ipv4( address.address );
+			}
+
+			// "PROXY TCP4|TCP6 source destination source_port destination_port" or "PROXY UNKNOWN ..."
+			constexpr size_t parse_proxy_v1( daw::string_view const str, proxy_header &header ) {
+				auto const line_end = str.substr( 0, proxy_v1_max_size ).find( "\r\n" );
+				if( line_end == daw::string_view::npos ) {
+					if( str.size( ) >= proxy_v1_max_size ) {
+						throw daw::parser::invalid_input_exception{};
+					}
+					return 0;
+				}
+				header = proxy_header{1, true, proxy_address_family::unspecified, proxy_transport::unspecified,
+				                      {}, {}, 0, 0, {}, {}, {}};
+				auto line = str.substr( 6, line_end - 6 );
+				auto const protocol = next_proxy_field( line );
+				if( protocol == "UNKNOWN" ) {
+					return line_end + 2;
+				}
+				bool const ipv6 = protocol == "TCP6";
+				if( !ipv6 && protocol != "TCP4" ) {
+					throw daw::parser::invalid_input_exception{};
+				}
+				header.local = false;
+				header.family = ipv6 ? proxy_address_family::inet6 : proxy_address_family::inet;
+				header.transport = proxy_transport::stream;
+				header.source = parse_proxy_v1_address( next_proxy_field( line ), ipv6 );
+				header.destination = parse_proxy_v1_address( next_proxy_field( line ), ipv6 );
+				header.source_port = daw::swar::parse_unsigned<uint16_t>( next_proxy_field( line ) );
+				header.destination_port = daw::swar::parse_unsigned<uint16_t>( next_proxy_field( line ) );
+				if( !line.empty( ) ) {
+					throw daw::parser::invalid_input_exception{};
+				}
+				return line_end + 2;
+			}
+
+			constexpr size_t parse_proxy_v2( daw::string_view const str, proxy_header &header ) {
+				if( str.size( ) < proxy_v2_header_size ) {
+					return 0;
+				}
+				auto const version_command = static_cast<uint8_t>( str[12] );
+				auto const family_transport = static_cast<uint8_t>( str[13] );
+				size_t const size = proxy_v2_header_size + get_be16( str.data( ) + 14 );
+				if( ( version_command >> 4 ) != 2 || ( version_command & 0xFU ) > 1 ) {
+					throw daw::parser::invalid_input_exception{};
+				}
+				if( str.size( ) < size ) {
+					return 0;
+				}
+				header = proxy_header{2, ( version_command & 0xFU ) == 0, proxy_address_family::unspecified,
+				                      proxy_transport::unspecified, {}, {}, 0, 0, {}, {}, {}};
+				auto const transport = family_transport & 0xFU;
+				if( transport > 2 ) {
+					throw daw::parser::invalid_input_exception{};
+				}
+				header.transport = static_cast<proxy_transport>( transport );
+				auto const block = str.substr( proxy_v2_header_size, size - proxy_v2_header_size );
+				size_t address_size = 0;
+				switch( family_transport >> 4 ) {
+				case 0:
+					break;
+				case 1:
+					address_size = 12;
+					if( block.size( ) < address_size ) {
+						throw daw::parser::invalid_input_exception{};
+					}
+					header.family = proxy_address_family::inet;
+					header.source = make_ipv4( get_be32( block.data( ) ) );
+					header.destination = make_ipv4( get_be32( block.data( ) + 4 ) );
+					header.source_port = get_be16( block.data( ) + 8 );
+					header.destination_port = get_be16( block.data( ) + 10 );
+					break;
+				case 2:
+					address_size = 36;
+					if( block.size( ) < address_size ) {
+						throw daw::parser::invalid_input_exception{};
+					}
+					header.family = proxy_address_family::inet6;
+					header.source = make_ipv6( block.data( ) );
+					header.destination = make_ipv6( block.data( ) + 16 );
+					header.source_port = get_be16( block.data( ) + 32 );
+					header.destination_port = get_be16( block.data( ) + 34 );
+					break;
+				case 3:
+					address_size = 2 * proxy_unix_path_size;
+					if( block.size( ) < address_size ) {
+						throw daw::parser::invalid_input_exception{};
+					}
+					header.family = proxy_address_family::unix_socket;
+					header.source_path = block.substr( 0, proxy_unix_path_size );
+					header.destination_path = block.substr( proxy_unix_path_size, proxy_unix_path_size );
+					break;
+				default:
+					throw daw::parser::invalid_input_exception{};
+				}
+				if( header.local ) {
+					// the addresses of a LOCAL header are to be ignored
+					header.family = proxy_address_family::unspecified;
+					header.source = http_host_address{};
+					header.destination = http_host_address{};
+					header.source_port = 0;
+					header.destination_port = 0;
+					header.source_path = daw::string_view{};
+					header.destination_path = daw::string_view{};
+				}
+				header.tlvs = block.substr( address_size );
+				return size;
+			}
+		} // namespace impl
+
+		// Which PROXY header, if any, str starts with.  A single 12 octet compare, done as two words, once 12 octets
+		// have arrived
+		constexpr proxy_protocol_prefix detect_proxy_protocol( daw::string_view const str ) noexcept {
+			auto const count = str.size( ) < 12 ? str.size( ) : 12;
+			uint64_t const low = daw::swar::load( str.data( ), count );
+			uint64_t const high = count > 8 ? daw::swar::load( str.data( ) + 8, count - 8 ) : 0;
+			uint64_t const low_mask = daw::swar::prefix_mask( count );
+			uint64_t const high_mask = count > 8 ? daw::swar::prefix_mask( count - 8 ) : 0;
+			if( ( low ^ impl::proxy_v2_signature_low ) == 0 && ( high ^ impl::proxy_v2_signature_high ) == 0 ) {
+				return proxy_protocol_prefix::v2;
+			}
+			if( ( ( low ^ impl::proxy_v1_signature ) & daw::swar::prefix_mask( 6 ) ) == 0 ) {
+				return count >= 6 ? proxy_protocol_prefix::v1 : proxy_protocol_prefix::incomplete;
+			}
+			if( count < 12 && ( ( low ^ impl::proxy_v2_signature_low ) & low_mask ) == 0 &&
+			    ( ( high ^ impl::proxy_v2_signature_high ) & high_mask ) == 0 ) {
+				return proxy_protocol_prefix::incomplete;
+			}
+			if( count < 6 && ( ( low ^ impl::proxy_v1_signature ) & low_mask ) == 0 ) {
+				return proxy_protocol_prefix::incomplete;
+			}
+			return proxy_protocol_prefix::none;
+		}
+
+		// Parse the PROXY header at the front of str.  Returns the offset where the HTTP request begins, 0 until the
+		// header has completely arrived.  The views in header point into str.  A connection that does not start with
+		// a PROXY header or a malformed one throws
+		constexpr size_t parse_proxy_header( daw::string_view const str, proxy_header &header ) {
+			switch( detect_proxy_protocol( str ) ) {
+			case proxy_protocol_prefix::v1:
+				return impl::parse_proxy_v1( str, header );
+			case proxy_protocol_prefix::v2:
+				return impl::parse_proxy_v2( str, header );
+			case proxy_protocol_prefix::incomplete:
+				return 0;
+			case proxy_protocol_prefix::none:
+				break;
+			}
+			throw daw::parser::invalid_input_exception{};
+		}
+	} // namespace http
+} // namespace daw
@@ -0,0 +1,224 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2017 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+#include <daw/daw_parser_helper.h>
+#include <daw/daw_string_view.h>
+
+#include "daw_swar.h"
+#include "http_headers.h"
+#include "http_limits.h"
+
+namespace daw {
+	namespace http {
+		// Inclusive, like the positions in a Content-Range
+		struct http_byte_range {
+			uint64_t first;
+			uint64_t last;
+
+			constexpr uint64_t size( ) const noexcept {
+				return last - first + 1;
+			}
+		};
+
+		// Satisfiable ranges of a Range header, normalised to the resource.  Empty when none were satisfiable, which
+		// is a 416 response
+		template<size_t Capacity>
+		struct basic_http_byte_ranges {
+			static_assert( Capacity > 0, "There must be room for one range" );
+			static constexpr size_t const capacity = Capacity;
+
+		private:
+			http_byte_range m_ranges[Capacity];
+			size_t m_size;
+
+		public:
+			constexpr basic_http_byte_ranges( ) noexcept : m_ranges{}, m_size{0} {}
+
+			constexpr void push_back( http_byte_range const range ) noexcept {
+				m_ranges[m_size++] = range;
+			}
+
+			// Sort by first and merge ranges that overlap or touch.  Insertion sort, there are at most Capacity
+			constexpr void coalesce( ) noexcept {
+				for( size_t n = 1; n < m_size; ++n ) {
+					auto const range = m_ranges[n];
+					size_t pos = n;
+					for( ; pos > 0 && m_ranges[pos - 1].first > range.first; --pos ) {
+						m_ranges[pos] = m_ranges[pos - 1];
+					}
+					m_ranges[pos] = range;
+				}
+				size_t count = 0;
+				for( size_t n = 0; n < m_size; ++n ) {
+					if( count > 0 && m_ranges[n].first <= m_ranges[count - 1].last + 1 ) {
+						if( m_ranges[n].last > m_ranges[count - 1].last ) {
+							m_ranges[count - 1].last = m_ranges[n].last;
+						}
+						continue;
+					}
+					m_ranges[count++] = m_ranges[n];
+				}
+				m_size = count;
+			}
+
+			constexpr size_t size( ) const noexcept {
+				return m_size;
+			}
+
+			constexpr bool empty( ) const noexcept {
+				return m_size == 0;
+			}
+
+			constexpr http_byte_range const *begin( ) const noexcept {
+				return m_ranges;
+			}
+
+			constexpr http_byte_range const *end( ) const noexcept {
+				return m_ranges + m_size;
+			}
+
+			constexpr http_byte_range const &operator[]( size_t const index ) const noexcept {
+				return m_ranges[index];
+			}
+
+			// Octets selected, the body size of a single part response
+			constexpr uint64_t total_size( ) const noexcept {
+				uint64_t result = 0;
+				for( auto const &range : *this ) {
+					result += range.size( );
+				}
+				return result;
+			}
+		};
+
+		using http_byte_ranges = basic_http_byte_ranges<16>;
+
+		namespace impl {
+			// A position in a range-spec.  Leading zeros are dropped first, more significant digits than a uint64_t
+			// holds saturate and those positions are past the end of any resource
+			constexpr uint64_t parse_range_position( daw::string_view str ) {
+				while( str.size( ) > 1 && str.front( ) == '0' ) {
+					str.remove_prefix( );
+				}
+				if( str.size( ) < daw::swar::max_digits<uint64_t>( ) ) {
+					return daw::swar::parse_unsigned<uint64_t>( str );
+				}
+				for( auto const c : str ) {
+					if( c < '0' || c > '9' ) {
+						throw daw::parser::invalid_input_exception{};
+					}
+				}
+				return std::numeric_limits<uint64_t>::max( );
+			}
+
+			// Number of ',' in str, 8 characters per step
+			constexpr size_t count_commas( daw::string_view const str ) noexcept {
+				size_t result = 0;
+				for( size_t pos = 0; pos < str.size( ); pos += 8 ) {
+					result += daw::swar::count_set_bytes( daw::swar::bytes_equal(
+					  daw::swar::load( str.data( ) + pos, str.size( ) - pos ), ',' ) );
+				}
+				return result;
+			}
+
+			// Number of list elements in str that are not empty or all OWS
+			constexpr size_t count_list_elements( daw::string_view const str ) noexcept {
+				size_t result = 0;
+				bool in_element = false;
+				for( auto const c : str ) {
+					if( c == ',' ) {
+						in_element = false;
+					} else if( !in_element && !is_ows( c ) ) {
+						in_element = true;
+						++result;
+					}
+				}
+				return result;
+			}
+		} // namespace impl
+
+		// Parse a "bytes=" Range value( RFC 9110 14.2 ) against a resource of resource_length octets.  The result is
+		// sorted and coalesced, and empty when no range is satisfiable.  A value with more than Capacity non-empty
+		// list elements throws http_limit_exceeded_exception before any of them are parsed, and a value that is not a
+		// valid bytes range set throws invalid_input_exception.  Either way the header should be ignored
+		template<size_t Capacity = http_byte_ranges::capacity>
+		constexpr basic_http_byte_ranges<Capacity> parse_byte_ranges( daw::string_view value,
+		                                                              uint64_t const resource_length ) {
+			value = impl::trim_ows( value );
+			if( value.size( ) < 6 || !impl::equal_ignore_case( value.substr( 0, 6 ), "bytes=" ) ) {
+				throw daw::parser::invalid_input_exception{};
+			}
+			value.remove_prefix( 6 );
+			// The comma count bounds the element count, only a value near the limit needs the exact count
+			if( impl::count_commas( value ) >= Capacity && impl::count_list_elements( value ) > Capacity ) {
+				throw http_limit_exceeded_exception{};
+			}
+			basic_http_byte_ranges<Capacity> result{};
+			bool found_spec = false;
+			while( !value.empty( ) ) {
+				auto const spec_end = value.find( ',' );
+				auto const spec = impl::trim_ows( value.substr( 0, spec_end ) );
+				value.remove_prefix( spec_end == daw::string_view::npos ? value.size( ) : spec_end + 1 );
+				if( spec.empty( ) ) {
+					// empty list elements are allowed
+					continue;
+				}
+				found_spec = true;
+				auto const dash = spec.find( '-' );
+				if( dash == daw::string_view::npos ) {
+					throw daw::parser::invalid_input_exception{};
+				}
+				if( dash == 0 ) {
+					// suffix-range, the last suffix_length octets
+					auto const suffix_length = impl::parse_range_position( spec.substr( 1 ) );
+					if( suffix_length > 0 && resource_length > 0 ) {
+						auto const length = suffix_length < resource_length ? suffix_length : resource_length;
+						result.push_back( http_byte_range{resource_length - length, resource_length - 1} );
+					}
+					continue;
+				}
+				auto const first = impl::parse_range_position( spec.substr( 0, dash ) );
+				auto last = std::numeric_limits<uint64_t>::max( );
+				if( dash + 1 < spec.size( ) ) {
+					last = impl::parse_range_position( spec.substr( dash + 1 ) );
+					if( last < first ) {
+						throw daw::parser::invalid_input_exception{};
+					}
+				}
+				if( first < resource_length ) {
+					result.push_back( http_byte_range{first, last < resource_length ? last : resource_length - 1} );
+				}
+			}
+			if( !found_spec ) {
+				throw daw::parser::invalid_input_exception{};
+			}
+			result.coalesce( );
+			return result;
+		}
+	} // namespace http
+} // namespace daw
@@ -23,6 +23,7 @@
 #pragma once
 
 #include <cstdint>
+#include <string>
 
 #include <daw/daw_parse_to.h>
 #include <daw/daw_string_view.h>
@@ -30,6 +31,10 @@
 #include <daw/daw_utility.h>
 
 #include "daw_parsing.h"
+#include "daw_swar.h"
+#include "http_headers.h"
+#include "http_limits.h"
+#include "ip_address_parser.h"
 
 namespace daw {
 	namespace http {
@@ -50,23 +55,48 @@ namespace daw {
 
 			using digit = chr_rng<'0', '9'>;
 			using safe = chr_set<'$', '-', '_', '@', '.', '&', '+', '-'>;
-			using extra = chr_set<'!', '*', '"', '/', '(', ')', ','>;
+			using extra = chr_set<'!', '*', '"', '(', ')', ','>;
 			using hex = any_of<chr_rng<'a', 'f'>, chr_rng<'A', 'F'>, chr_rng<'0', '9'>>;
 			using reserved = chr_set<'=', ';', '/', '#', '?', ':', ' '>;
 			using alphanum2 = any_of<alpha, digit, chr_set<'-', '_', '.', '+'>>;
 
-			using escape = sequence<chr<'%'>, hex, hex>;
+			// RFC 7230 token characters, used for field names, cookie names and parameters
+			using tchar =
+			  any_of<alpha, digit, chr_set<'!', '#', '$', '%', '&', '\'', '*', '+', '-', '.', '^', '_', '`', '|', '~'>>;
 
-			struct xalpha {
-				using check_type = any_of<alpha, digit, safe, extra, escape>;
+			struct escape {
+				static CONSTEXPR test_result check( daw::string_view const str ) noexcept {
+					bool const found = str.size( ) >= 3 && str[0] == '%' && hex::check( str[1] ) && hex::check( str[2] );
+					return test_result{0, found ? 3U : 0U, found};
+				}
+			};
+
+			// CharClass plus percent escapes.  A single character check cannot see a whole escape so it does not allow
+			// '%', the string check allows it only where it starts a valid escape
+			template<typename CharClass>
+			struct escaped {
 				static CONSTEXPR bool check( char const c ) noexcept {
-					return check_type::check( c );
+					return CharClass::check( c );
 				}
 				static CONSTEXPR test_result check( daw::string_view const str ) noexcept {
-					return check_str<check_type>( str );
+					size_t n = 0;
+					while( n < str.size( ) ) {
+						if( str[n] == '%' ) {
+							if( !escape::check( str.substr( n ) ) ) {
+								break;
+							}
+							n += 3;
+						} else if( CharClass::check( str[n] ) ) {
+							++n;
+						} else {
+							break;
+						}
+					}
+					return test_result{0, n, n != 0};
 				}
 			};
-			using xpalpha = any_of<xalpha, chr<'+'>>;
+			using xalpha = escaped<any_of<alpha, digit, safe, extra>>;
+			using xpalpha = escaped<any_of<alpha, digit, safe, extra, chr<'+'>>>;
 
 			// str only
 			using ialpha = sequence<alpha, zero_or_more<xalpha>>;
@@ -83,15 +113,20 @@ namespace daw {
 			// high level
 			using scheme = parse_parts<ialpha, chr_seq<':', '/', '/'>>;
 			using userinfo = parse_parts<username, chr<':'>, password, chr<'@'>>;
-			using host = parse_parts<one_of<hostname, hostnumber>>;
+			// numeric hosts are recognized by parse_ipv4_prefix before falling back to host
+			using host = parse_parts<hostname>;
 			using port = parse_parts<chr<':'>, portnumber>;
-			using path = parse_parts<zero_or_more<sequence<chr<'/'>, segment>>>;
+			using path = parse_parts<zero_or_more<sequence<chr<'/'>, zero_or_more<segment>>>>;
 			using query = parse_parts<chr<'?'>, sequence<xalphas, zero_or_more<sequence<chr<'+'>, xalphas>>>>;
 			using fragment = parse_parts<chr<'#'>, xpalphas>;
 		} // namespace char_sets
 
+		// Port of a URI that does not give one
+		constexpr uint16_t const default_http_port = 80;
+
 		enum class request_method : int_fast8_t { OPTIONS = 0, GET, HEAD, POST, PUT, DELETE, TRACE, CONNECT };
-		std::string to_string( request_method method ) {
+		// Name of the method without building a std::string, for paths that run once per request
+		CONSTEXPR daw::string_view to_string_view( request_method const method ) {
 			switch( method ) {
 			case request_method::OPTIONS:
 				return "OPTIONS";
@@ -110,7 +145,11 @@ namespace daw {
 			case request_method::CONNECT:
 				return "CONNECT";
 			}
-			std::terminate( );
+			throw daw::parser::invalid_input_exception{};
+		}
+
+		inline std::string to_string( request_method const method ) {
+			return to_string_view( method ).to_string( );
 		}
 
 		struct http_version {
@@ -130,17 +169,19 @@ namespace daw {
 			daw::string_view scheme;
 			http_url_auth_info auth;
 			daw::string_view host;
+			http_host_address address;
 			uint16_t port;
 			daw::string_view path;
 			daw::string_view query;
 			daw::string_view fragment;
 
-			CONSTEXPR http_uri( ) noexcept : scheme{}, auth{}, host{}, port{}, path{}, query{}, fragment{} {}
+			CONSTEXPR http_uri( ) noexcept : scheme{}, auth{}, host{}, address{}, port{}, path{}, query{}, fragment{} {}
 
 			CONSTEXPR http_uri( http_uri const &other ) noexcept
 			  : scheme{other.scheme}
 			  , auth{other.auth}
 			  , host{other.host}
+			  , address{other.address}
 			  , port{other.port}
 			  , path{other.path}
 			  , query{other.query}
@@ -150,6 +191,7 @@ namespace daw {
 			  : scheme{std::move( other.scheme )}
 			  , auth{std::move( other.auth )}
 			  , host{std::move( other.host )}
+			  , address{std::move( other.address )}
 			  , port{std::move( other.port )}
 			  , path{std::move( other.path )}
 			  , query{std::move( other.query )}
@@ -160,6 +202,7 @@ namespace daw {
 					scheme = rhs.scheme;
 					auth = rhs.auth;
 					host = rhs.host;
+					address = rhs.address;
 					port = rhs.port;
 					path = rhs.path;
 					query = rhs.query;
@@ -173,6 +216,7 @@ namespace daw {
 					scheme = std::move( rhs.scheme );
 					auth = std::move( rhs.auth );
 					host = std::move( rhs.host );
+					address = std::move( rhs.address );
 					port = std::move( rhs.port );
 					path = std::move( rhs.path );
 					query = std::move( rhs.query );
@@ -183,11 +227,12 @@ namespace daw {
 
 			~http_uri( ) noexcept = default;
 
-			CONSTEXPR http_uri( daw::string_view s, http_url_auth_info a, daw::string_view h, uint16_t p, daw::string_view pa,
-			                    daw::string_view q, daw::string_view f ) noexcept
+			CONSTEXPR http_uri( daw::string_view s, http_url_auth_info a, daw::string_view h, http_host_address ha, uint16_t p,
+			                    daw::string_view pa, daw::string_view q, daw::string_view f ) noexcept
 			  : scheme{std::move( s )}
 			  , auth{std::move( a )}
 			  , host{std::move( h )}
+			  , address{std::move( ha )}
 			  , port{std::move( p )}
 			  , path{std::move( pa )}
 			  , query{std::move( q )}
@@ -198,20 +243,25 @@ namespace daw {
 			request_method method;
 			http_uri uri;
 			http_version version;
+			known_header_set headers_present;
 
-			CONSTEXPR http_request( ) noexcept : method{}, uri{}, version{} {}
+			CONSTEXPR http_request( ) noexcept : method{}, uri{}, version{}, headers_present{0} {}
 
 			CONSTEXPR http_request( http_request const &other ) noexcept
-			  : method{other.method}, uri{other.uri}, version{other.version} {}
+			  : method{other.method}, uri{other.uri}, version{other.version}, headers_present{other.headers_present} {}
 
 			CONSTEXPR http_request( http_request &&other ) noexcept
-			  : method{std::move( other.method )}, uri{std::move( other.uri )}, version{std::move( other.version )} {}
+			  : method{std::move( other.method )}
+			  , uri{std::move( other.uri )}
+			  , version{std::move( other.version )}
+			  , headers_present{std::move( other.headers_present )} {}
 
 			CONSTEXPR http_request &operator=( http_request const &rhs ) noexcept {
 				if( this != &rhs ) {
 					method = rhs.method;
 					uri = rhs.uri;
 					version = rhs.version;
+					headers_present = rhs.headers_present;
 				}
 				return *this;
 			}
@@ -221,13 +271,14 @@ namespace daw {
 					method = std::move( rhs.method );
 					uri = std::move( rhs.uri );
 					version = std::move( rhs.version );
+					headers_present = std::move( rhs.headers_present );
 				}
 				return *this;
 			}
 
 			~http_request( ) noexcept = default;
 			CONSTEXPR http_request( request_method m, http_uri u, http_version v ) noexcept
-			  : method{std::move( m )}, uri{std::move( u )}, version{std::move( v )} {}
+			  : method{std::move( m )}, uri{std::move( u )}, version{std::move( v )}, headers_present{0} {}
 		};
 
 		CONSTEXPR request_method parse_to_value( daw::string_view str, request_method ) {
@@ -280,10 +331,12 @@ namespace daw {
 				throw daw::parser::invalid_input_exception{};
 			}
 			str.remove_prefix( 5 );
-			if( str.size( ) < 3 ) {
+			if( str.size( ) != 3 || !char_sets::digit::check( str[0] ) || str[1] != '.' ||
+			    !char_sets::digit::check( str[2] ) ) {
 				throw daw::parser::invalid_input_exception{};
 			}
-			return http_version{static_cast<uint_fast8_t>( str[0] - '0' ), static_cast<uint_fast8_t>( str[2] - '0' )};
+			// members are minor then major
+			return http_version{static_cast<uint_fast8_t>( str[2] - '0' ), static_cast<uint_fast8_t>( str[0] - '0' )};
 		}
 
 		struct unquoted_string_view {};
@@ -293,13 +346,8 @@ namespace daw {
 		}
 
 		CONSTEXPR http_url_auth_info parse_to_value( daw::string_view str, http_url_auth_info ) {
-			{
-				auto const end_pos = str.find( '@' );
-				if( end_pos >= str.size( ) ) {
-					return http_url_auth_info{};
-				}
-				str = str.substr( 0, end_pos );
-			}
+			// The '@' ending the userinfo is optional, impl::parse_auth_info has already removed it
+			str = str.substr( 0, str.find( '@' ) );
 			auto const mid_pos = str.find( ':' );
 			if( mid_pos >= str.size( ) ) {
 				return http_url_auth_info{str, {}};
@@ -309,13 +357,18 @@ namespace daw {
 
 		struct http_url_port {};
 		CONSTEXPR uint16_t parse_to_value( daw::string_view str, http_url_port ) {
-			return daw::parser::converters::helpers::parse_unsigned_int<uint16_t>( str );
+			return daw::swar::parse_unsigned<uint16_t>( str );
+		}
+
+		struct http_content_length {};
+		CONSTEXPR uint64_t parse_to_value( daw::string_view str, http_content_length ) {
+			return daw::swar::parse_unsigned<uint64_t>( str );
 		}
 
 		namespace impl {
 			CONSTEXPR daw::string_view parse_scheme( daw::string_view &str, bool req ) {
 				auto parse_result = char_sets::scheme::check( str );
-				if( !( std::get<0>( parse_result ) && std::get<0>( parse_result ) ) ) {
+				if( !( std::get<0>( parse_result ) && std::get<1>( parse_result ) ) ) {
 					if( req ) {
 						throw daw::parser::invalid_input_exception{};
 					}
@@ -326,25 +379,71 @@ namespace daw {
 				return result;
 			}
 
+			// The authority ends at the first '/', '?' or '#'
+			CONSTEXPR size_t find_authority_end( daw::string_view const str ) noexcept {
+				size_t n = 0;
+				for( ; n < str.size( ) && str[n] != '/' && str[n] != '?' && str[n] != '#'; ++n ) {
+				}
+				return n;
+			}
+
 			CONSTEXPR http_url_auth_info parse_auth_info( daw::string_view &str ) {
-				auto const auth_end = str.find( '@' );
+				auto const authority_end = find_authority_end( str );
+				auto const auth_end = str.substr( 0, authority_end ).find( '@' );
 				if( auth_end != str.npos ) {
 					auto auth_info = parse_to_value( str.substr( 0, auth_end ), http_url_auth_info{} );
 					str.remove_prefix( auth_end + 1 );
 					return auth_info;
 				}
+				// An '@' in a fragment that directly follows the authority( e.g. http://a.com#@b.com ) is taken as
+				// userinfo by some parsers and as part of the fragment by others.  Refuse to pick one.  Once a path or
+				// query has started an '@' is ordinary data, e.g. http://a.com?email=a@b.com
+				auto const rest = str.substr( authority_end );
+				if( !rest.empty( ) && rest.front( ) == '#' && rest.find( '@' ) != rest.npos ) {
+					throw daw::parser::invalid_input_exception{};
+				}
 				return http_url_auth_info{};
 			}
 
 			struct hostinfo_t {
 				daw::string_view hostname;
+				http_host_address address;
 				uint16_t port;
 			};
 
-			CONSTEXPR daw::string_view parse_hostname( daw::string_view &str, bool req ) {
-				if( !req && !str.empty( ) ) {
+			CONSTEXPR bool is_host_end( daw::string_view const str, size_t const pos ) noexcept {
+				return pos == str.size( ) || str[pos] == ':' || str[pos] == '/' || str[pos] == '?' || str[pos] == '#';
+			}
+
+			// IPv6 literals are returned without their brackets
+			CONSTEXPR daw::string_view parse_hostname( daw::string_view &str, bool req, http_host_address &address ) {
+				address = http_host_address{host_type::reg_name, 0, {}};
+				if( !req && ( str.empty( ) || str.front( ) == '/' ) ) {
 					return daw::string_view{};
 				}
+				if( !str.empty( ) && str.front( ) == '[' ) {
+					auto const literal_end = str.find( ']' );
+					if( literal_end == str.npos || !is_host_end( str, literal_end + 1 ) ) {
+						throw daw::parser::invalid_input_exception{};
+					}
+					auto result = str.substr( 1, literal_end - 1 );
+					auto const ipv6 = parse_ipv6( result );
+					if( !ipv6 ) {
+						throw daw::parser::invalid_input_exception{};
+					}
+					address.type = host_type::ipv6;
+					address.ipv6 = ipv6.address;
+					str.remove_prefix( literal_end + 1 );
+					return result;
+				}
+				auto const ipv4 = parse_ipv4_prefix( str );
+				if( ipv4 && is_host_end( str, ipv4.size ) ) {
+					address.type = host_type::ipv4;
+					address.ipv4 = ipv4.address;
+					auto result = str.substr( 0, ipv4.size );
+					str.remove_prefix( ipv4.size );
+					return result;
+				}
 				auto parse_item = char_sets::host::check( str );
 
 				if( !std::get<0>( parse_item ) ) {
@@ -356,17 +455,19 @@ namespace daw {
 			}
 
 			CONSTEXPR uint16_t parse_port( daw::string_view &str ) {
-				if( str.empty( ) || str.front( ) == '/' ) {
-					return 80;
+				if( str.empty( ) || str.front( ) != ':' ) {
+					return default_http_port;
 				}
-				auto const port_end = str.find( '/' );
+				str.remove_prefix( );
+				auto const port_end = find_authority_end( str );
 				auto port = parse_to_value( str.substr( 0, port_end ), http_url_port{} );
 				str.remove_prefix( port_end );
 				return port;
 			}
 
 			CONSTEXPR hostinfo_t parse_hostinfo( daw::string_view &str, bool req ) {
-				hostinfo_t result{parse_hostname( str, req ), 80};
+				hostinfo_t result{{}, {}, default_http_port};
+				result.hostname = parse_hostname( str, req, result.address );
 				result.port = parse_port( str );
 				return result;
 			}
@@ -382,6 +483,14 @@ namespace daw {
 			}
 
 			CONSTEXPR daw::string_view parse_query( daw::string_view &str ) {
+				if( str.empty( ) ) {
+					return daw::string_view{};
+				}
+				if( str.front( ) == '?' ) {
+					str.remove_prefix( );
+				} else if( str.front( ) != '#' ) {
+					throw daw::parser::invalid_input_exception{};
+				}
 				auto const query_end = str.find( '#' );
 				auto query = str.substr( 0, query_end );
 				str.remove_prefix( query_end );
@@ -399,8 +508,114 @@ namespace daw {
 			auto path = impl::parse_path( str );
 			auto query = impl::parse_query( str );
 			return http_uri{std::move( scheme ), std::move( auth_info ), std::move( host_info.hostname ),
-			                host_info.port,      std::move( path ),      std::move( query ),
-			                std::move( str )};
+			                std::move( host_info.address ), host_info.port, std::move( path ),
+			                std::move( query ), std::move( str )};
+		}
+
+		// parse_to_value for a URI on its own, e.g. for tables of upstream URLs checked at compile time
+		CONSTEXPR http_uri parse_uri( daw::string_view const str ) {
+			return parse_to_value( str, http_uri{} );
+		}
+
+		// "method SP request-target SP HTTP-version", the same split that construct_from does with a
+		// single_whitespace_splitter but usable in a constant expression
+		CONSTEXPR http_request parse_request_line( daw::string_view const line ) {
+			auto const method_end = line.find( ' ' );
+			if( method_end == daw::string_view::npos ) {
+				throw daw::parser::invalid_input_exception{};
+			}
+			auto const target_end = line.find( ' ', method_end + 1 );
+			if( target_end == daw::string_view::npos || target_end == method_end + 1 ||
+			    line.find( ' ', target_end + 1 ) != daw::string_view::npos ) {
+				throw daw::parser::invalid_input_exception{};
+			}
+			return http_request{parse_to_value( line.substr( 0, method_end ), request_method{} ),
+			                    parse_to_value( line.substr( method_end + 1, target_end - method_end - 1 ), http_uri{} ),
+			                    parse_to_value( line.substr( target_end + 1 ), http_version{} )};
+		}
+
+		namespace impl {
+			// Where a scan of an incomplete request line stopped, so that it can continue once more has arrived
+			struct request_line_scan {
+				size_t pos;
+				size_t escapes;
+				size_t component_start;
+			};
+
+			// Position of the CR ending the request line, npos when it has not arrived yet.  Works like find_line_end
+			// and checks the limits in the same pass, nothing past the first character over a limit is looked at.
+			// Starts where state stopped, str must begin with the same characters as last time
+			constexpr size_t scan_request_line( daw::string_view const str, http_limits const &limits,
+			                                    request_line_scan &state ) {
+				size_t &pos = state.pos;
+				size_t &escapes = state.escapes;
+				size_t &component_start = state.component_start;
+				while( pos < str.size( ) ) {
+					uint64_t const word = daw::swar::load( str.data( ) + pos, str.size( ) - pos );
+					uint64_t const allowed = daw::swar::bytes_between( word, 0x20, 0x7E ) |
+					                         daw::swar::bytes_equal( word, '\t' ) | ( word & daw::swar::hi_bits );
+					size_t const count = daw::swar::leading_set_bytes( allowed );
+					uint64_t const in_line = daw::swar::prefix_mask( count ) & daw::swar::hi_bits;
+
+					escapes += daw::swar::count_set_bytes( daw::swar::bytes_equal( word, '%' ) & in_line );
+					if( escapes > limits.max_percent_escapes ) {
+						throw http_limit_exceeded_exception{};
+					}
+					uint64_t separators = ( daw::swar::bytes_equal( word, ' ' ) | daw::swar::bytes_equal( word, '?' ) |
+					                        daw::swar::bytes_equal( word, '#' ) ) &
+					                      in_line;
+					while( separators != 0 ) {
+						size_t const separator = pos + daw::swar::first_set_byte( separators );
+						if( separator - component_start > limits.max_uri_component ) {
+							throw http_limit_exceeded_exception{};
+						}
+						component_start = separator + 1;
+						separators &= separators - 1;
+					}
+					pos += count;
+					if( pos > limits.max_request_line || pos - component_start > limits.max_uri_component ) {
+						throw http_limit_exceeded_exception{};
+					}
+					if( count < 8 ) {
+						if( pos >= str.size( ) ) {
+							break;
+						}
+						if( str[pos] != '\r' ) {
+							throw daw::parser::invalid_input_exception{};
+						}
+						if( pos + 1 >= str.size( ) ) {
+							break;
+						}
+						if( str[pos + 1] != '\n' ) {
+							throw daw::parser::invalid_input_exception{};
+						}
+						return pos;
+					}
+				}
+				return daw::string_view::npos;
+			}
+
+			constexpr size_t scan_request_line( daw::string_view const str, http_limits const &limits ) {
+				request_line_scan state{0, 0, 0};
+				return scan_request_line( str, limits, state );
+			}
+		} // namespace impl
+
+		// Parse the request line and the header block.  Returns the number of characters used or 0 when the head
+		// has not been completely received yet.  Throws http_limit_exceeded_exception when it is larger than limits
+		inline size_t parse_request_head( daw::string_view const str, http_request &request, http_header_index &headers,
+		                                  http_limits const &limits = http_limits{} ) {
+			auto const line_end = impl::scan_request_line( str, limits );
+			if( line_end == daw::string_view::npos ) {
+				return 0;
+			}
+			auto const header_size = parse_headers( str.substr( line_end + 2 ), headers, limits );
+			if( header_size == 0 ) {
+				return 0;
+			}
+			request = parse_request_line( str.substr( 0, line_end ) );
+			request.headers_present = headers.present( );
+			return line_end + 2 + header_size;
 		}
 	} // namespace http
 } // namespace daw
@@ -0,0 +1,322 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2017 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <utility>
+
+#include <daw/daw_string_view.h>
+
+#include "http_headers.h"
+#include "http_req_parser.h"
+
+namespace daw {
+	namespace http {
+		// Recycles blocks in power of two size classes from 512 bytes to 64KiB, larger requests go to operator new.
+		// Blocks may be returned from another thread than the one that took them.  At most max_cached blocks of each
+		// class are kept
+		struct http_block_pool {
+			static constexpr size_t const min_block_size = 512;
+			static constexpr size_t const class_count = 8;
+			static constexpr size_t const max_cached = 256;
+
+		private:
+			struct free_block {
+				free_block *next;
+			};
+
+			std::mutex m_mutex;
+			free_block *m_free[class_count];
+			size_t m_cached[class_count];
+
+			static constexpr size_t size_class( size_t const size ) noexcept {
+				size_t result = 0;
+				while( result < class_count && ( min_block_size << result ) < size ) {
+					++result;
+				}
+				return result;
+			}
+
+		public:
+			http_block_pool( ) noexcept : m_mutex{}, m_free{}, m_cached{} {}
+
+			http_block_pool( http_block_pool const & ) = delete;
+			http_block_pool &operator=( http_block_pool const & ) = delete;
+
+			~http_block_pool( ) noexcept {
+				for( auto block : m_free ) {
+					while( block != nullptr ) {
+						auto next = block->next;
+						::operator delete( block );
+						block = next;
+					}
+				}
+			}
+
+			void *allocate( size_t const size ) {
+				auto const cls = size_class( size );
+				if( cls == class_count ) {
+					return ::operator new( size );
+				}
+				{
+					std::lock_guard<std::mutex> lock{m_mutex};
+					if( m_free[cls] != nullptr ) {
+						auto result = m_free[cls];
+						m_free[cls] = result->next;
+						--m_cached[cls];
+						return result;
+					}
+				}
+				return ::operator new( min_block_size << cls );
+			}
+
+			// size must be the size given to allocate
+			void deallocate( void *const ptr, size_t const size ) noexcept {
+				if( ptr == nullptr ) {
+					return;
+				}
+				auto const cls = size_class( size );
+				if( cls != class_count ) {
+					std::lock_guard<std::mutex> lock{m_mutex};
+					if( m_cached[cls] < max_cached ) {
+						m_free[cls] = new( ptr ) free_block{m_free[cls]};
+						++m_cached[cls];
+						return;
+					}
+				}
+				::operator delete( ptr );
+			}
+
+			// Number of blocks waiting to be reused
+			size_t cached( ) noexcept {
+				std::lock_guard<std::mutex> lock{m_mutex};
+				size_t result = 0;
+				for( auto const count : m_cached ) {
+					result += count;
+				}
+				return result;
+			}
+		};
+
+		namespace impl {
+			template<typename Function>
+			void for_each_view( http_request &request, http_header *const headers, size_t const header_count,
+			                    Function func ) {
+				func( request.uri.scheme );
+				func( request.uri.auth.username );
+				func( request.uri.auth.password );
+				func( request.uri.host );
+				func( request.uri.path );
+				func( request.uri.query );
+				func( request.uri.fragment );
+				for( size_t n = 0; n < header_count; ++n ) {
+					func( headers[n].name );
+					func( headers[n].value );
+				}
+			}
+		} // namespace impl
+
+		// A request and its headers that own their text, all of it in one block from Arena.  Arena needs
+		//   void *allocate( size_t )
+		//   void deallocate( void *, size_t )
+		// and must outlive the snapshot.  Each view is copied on its own.  When the caller passes the receive buffer
+		// the request was parsed from as source and every view lies inside it, close together, the range they
+		// cover is copied with one memcpy and the views are rebased into the copy instead.  Views into other
+		// storage, such as HPACK's decode buffer or literal header names, always take the first path.  Either way
+		// there is a single allocation
+		template<typename Arena>
+		struct basic_http_request_snapshot {
+		private:
+			Arena *m_arena;
+			void *m_block;
+			size_t m_block_size;
+			http_request m_request;
+			http_header *m_headers;
+			size_t m_header_count;
+
+			void release( ) noexcept {
+				if( m_block != nullptr ) {
+					m_arena->deallocate( m_block, m_block_size );
+					m_block = nullptr;
+				}
+			}
+
+		public:
+			basic_http_request_snapshot( http_request const &request, http_header_index const &headers, Arena &arena )
+			  : basic_http_request_snapshot{request, headers, daw::string_view{}, arena} {}
+
+			basic_http_request_snapshot( http_request const &request, http_header_index const &headers,
+			                             daw::string_view const source, Arena &arena )
+			  : m_arena{&arena}
+			  , m_block{nullptr}
+			  , m_block_size{0}
+			  , m_request{request}
+			  , m_headers{nullptr}
+			  , m_header_count{headers.size( )} {
+
+				// The headers are copied into the front of the block so that they can be rebased with the rest
+				http_header header_copy[http_header_index::capacity];
+				std::copy( headers.begin( ), headers.end( ), header_copy );
+
+				char const *first = nullptr;
+				char const *last = nullptr;
+				size_t total = 0;
+				bool inside_source = !source.empty( );
+				impl::for_each_view( m_request, header_copy, m_header_count, [&]( daw::string_view const &view ) {
+					if( view.empty( ) ) {
+						return;
+					}
+					total += view.size( );
+					inside_source = inside_source && view.data( ) >= source.data( ) &&
+					                view.data( ) + view.size( ) <= source.data( ) + source.size( );
+					if( first == nullptr || view.data( ) < first ) {
+						first = view.data( );
+					}
+					if( last == nullptr || view.data( ) + view.size( ) > last ) {
+						last = view.data( ) + view.size( );
+					}
+				} );
+				auto const span = static_cast<size_t>( last - first );
+				bool const contiguous = inside_source && span <= 2 * total;
+				size_t const header_bytes = m_header_count * sizeof( http_header );
+
+				m_block_size = header_bytes + ( contiguous ? span : total );
+				if( m_block_size == 0 ) {
+					m_block_size = 1;
+				}
+				m_block = m_arena->allocate( m_block_size );
+				m_headers = static_cast<http_header *>( m_block );
+				char *const text = static_cast<char *>( m_block ) + header_bytes;
+
+				if( contiguous ) {
+					if( span != 0 ) {
+						std::memcpy( text, first, span );
+					}
+					impl::for_each_view( m_request, header_copy, m_header_count, [&]( daw::string_view &view ) {
+						if( view.empty( ) ) {
+							view = daw::string_view{};
+							return;
+						}
+						view = daw::string_view{text + ( view.data( ) - first ), view.size( )};
+					} );
+				} else {
+					size_t pos = 0;
+					impl::for_each_view( m_request, header_copy, m_header_count, [&]( daw::string_view &view ) {
+						if( view.empty( ) ) {
+							view = daw::string_view{};
+							return;
+						}
+						std::memcpy( text + pos, view.data( ), view.size( ) );
+						view = daw::string_view{text + pos, view.size( )};
+						pos += view.size( );
+					} );
+				}
+				for( size_t n = 0; n < m_header_count; ++n ) {
+					new( m_headers + n ) http_header( header_copy[n] );
+				}
+			}
+
+			basic_http_request_snapshot( basic_http_request_snapshot &&other ) noexcept
+			  : m_arena{other.m_arena}
+			  , m_block{std::exchange( other.m_block, nullptr )}
+			  , m_block_size{other.m_block_size}
+			  , m_request{other.m_request}
+			  , m_headers{other.m_headers}
+			  , m_header_count{other.m_header_count} {}
+
+			basic_http_request_snapshot &operator=( basic_http_request_snapshot &&rhs ) noexcept {
+				if( this != &rhs ) {
+					release( );
+					m_arena = rhs.m_arena;
+					m_block = std::exchange( rhs.m_block, nullptr );
+					m_block_size = rhs.m_block_size;
+					m_request = rhs.m_request;
+					m_headers = rhs.m_headers;
+					m_header_count = rhs.m_header_count;
+				}
+				return *this;
+			}
+
+			basic_http_request_snapshot( basic_http_request_snapshot const & ) = delete;
+			basic_http_request_snapshot &operator=( basic_http_request_snapshot const & ) = delete;
+
+			~basic_http_request_snapshot( ) noexcept {
+				release( );
+			}
+
+			http_request const &request( ) const noexcept {
+				return m_request;
+			}
+
+			http_header const *begin( ) const noexcept {
+				return m_headers;
+			}
+
+			http_header const *end( ) const noexcept {
+				return m_headers + m_header_count;
+			}
+
+			size_t header_count( ) const noexcept {
+				return m_header_count;
+			}
+
+			// Value of the first header with that id, empty if not present
+			daw::string_view operator[]( known_header const header ) const noexcept {
+				if( !m_request.headers_present.contains( header ) ) {
+					return daw::string_view{};
+				}
+				for( auto const &h : *this ) {
+					if( h.id == header ) {
+						return h.value;
+					}
+				}
+				return daw::string_view{};
+			}
+
+			// Bytes taken from the arena
+			size_t block_size( ) const noexcept {
+				return m_block_size;
+			}
+		};
+
+		using http_request_snapshot = basic_http_request_snapshot<http_block_pool>;
+
+		template<typename Arena>
+		basic_http_request_snapshot<Arena> make_request_snapshot( http_request const &request,
+		                                                          http_header_index const &headers, Arena &arena ) {
+			return basic_http_request_snapshot<Arena>{request, headers, arena};
+		}
+
+		// source is the buffer request and headers were parsed from
+		template<typename Arena>
+		basic_http_request_snapshot<Arena> make_request_snapshot( http_request const &request,
+		                                                          http_header_index const &headers,
+		                                                          daw::string_view const source, Arena &arena ) {
+			return basic_http_request_snapshot<Arena>{request, headers, source, arena};
+		}
+	} // namespace http
+} // namespace daw
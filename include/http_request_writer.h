@@ -0,0 +1,212 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2017 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <initializer_list>
+
+#include <daw/daw_exception.h>
+#include <daw/daw_string_view.h>
+
+#include "daw_swar.h"
+#include "http_headers.h"
+#include "http_req_parser.h"
+
+#if defined( __unix__ ) || defined( __APPLE__ )
+#include <sys/uio.h>
+#endif
+
+namespace daw {
+	namespace http {
+		// Same members as a POSIX iovec, but const correct
+		struct io_segment {
+			char const *data;
+			size_t size;
+		};
+
+		// Re-emits a parsed request head( request line and headers, as passed to parse_request_head ) with some parts
+		// replaced.  Unchanged spans are segments pointing into the original head and replacements point at the
+		// caller's views, so nothing is copied until write is called and nothing is allocated.  All views passed in
+		// must outlive the writer
+		template<size_t MaxEdits = 8>
+		struct basic_http_request_writer {
+			static constexpr size_t const max_parts = 4;
+			static constexpr size_t const max_segments = MaxEdits * ( max_parts + 1 ) + 1;
+
+		private:
+			struct edit_t {
+				size_t first;
+				size_t last;
+				daw::string_view parts[max_parts];
+				size_t part_count;
+			};
+
+			daw::string_view m_head;
+			std::array<edit_t, MaxEdits> m_edits;
+			size_t m_edit_count;
+
+			size_t offset_of( char const *ptr ) const {
+				daw::exception::daw_throw_on_false( m_head.data( ) <= ptr && ptr <= m_head.data( ) + m_head.size( ),
+				                                    "View is not part of the request head" );
+				return static_cast<size_t>( ptr - m_head.data( ) );
+			}
+
+			void add_edit( size_t const first, size_t const last, std::initializer_list<daw::string_view> parts ) {
+				daw::exception::daw_throw_on_false( m_edit_count < MaxEdits, "Too many edits to request" );
+				daw::exception::daw_throw_on_false( first <= last && last <= m_head.size( ), "Invalid edit range" );
+				edit_t edit{first, last, {}, 0};
+				for( auto const &part : parts ) {
+					edit.parts[edit.part_count++] = part;
+				}
+				// keep edits ordered by position, insertions at the same position stay in the order they were made
+				size_t pos = m_edit_count;
+				while( pos > 0 && m_edits[pos - 1].first > first ) {
+					--pos;
+				}
+				daw::exception::daw_throw_on_false( pos == 0 || m_edits[pos - 1].last <= first,
+				                                    "Edits to a request cannot overlap" );
+				daw::exception::daw_throw_on_false( pos == m_edit_count || last <= m_edits[pos].first,
+				                                    "Edits to a request cannot overlap" );
+				std::move_backward( m_edits.begin( ) + pos, m_edits.begin( ) + m_edit_count,
+				                    m_edits.begin( ) + m_edit_count + 1 );
+				m_edits[pos] = edit;
+				++m_edit_count;
+			}
+
+		public:
+			explicit basic_http_request_writer( daw::string_view const head ) noexcept
+			  : m_head{head}, m_edits{}, m_edit_count{0} {}
+
+			// Replace original, a view into the head, with replacement
+			void replace( daw::string_view const original, daw::string_view const replacement ) {
+				auto const first = offset_of( original.data( ) );
+				add_edit( first, first + original.size( ), {replacement} );
+			}
+
+			void set_path( http_request const &request, daw::string_view const path ) {
+				replace( request.uri.path, path );
+			}
+
+			// query is without the '?'.  When the target has no query one is added after the path
+			void set_query( http_request const &request, daw::string_view const query ) {
+				auto const path_end = offset_of( request.uri.path.data( ) ) + request.uri.path.size( );
+				if( path_end < m_head.size( ) && m_head[path_end] == '?' ) {
+					replace( request.uri.query, query );
+				} else if( !query.empty( ) ) {
+					add_edit( path_end, path_end, {"?", query} );
+				}
+			}
+
+			// Rewrites the host of an absolute-form request target and the value of the Host header, whichever exist
+			void set_host( http_request const &request, http_header_index const &headers, daw::string_view const host ) {
+				if( !request.uri.host.empty( ) ) {
+					replace( request.uri.host, host );
+				}
+				if( headers.contains( known_header::host ) ) {
+					replace( headers[known_header::host], host );
+				}
+			}
+
+			// Drop the whole line of a header from the index
+			void remove_header( http_header const &header ) {
+				auto const first = offset_of( header.name.data( ) );
+				auto const line_end = daw::swar::find( m_head, '\n', offset_of( header.value.data( ) ) );
+				daw::exception::daw_throw_on_false( line_end != daw::string_view::npos, "Header is not terminated" );
+				add_edit( first, line_end + 1, {} );
+			}
+
+			// Add a header after the existing ones
+			void add_header( daw::string_view const name, daw::string_view const value ) {
+				daw::exception::daw_throw_on_false( m_head.size( ) >= 2, "Request head is not complete" );
+				auto const pos = m_head.size( ) - 2;
+				add_edit( pos, pos, {name, ": ", value, "\r\n"} );
+			}
+
+			// Fill out with the segments of the rewritten head, empty segments are skipped.  Returns the count used
+			size_t segments( std::array<io_segment, max_segments> &out ) const noexcept {
+				size_t count = 0;
+				size_t pos = 0;
+				auto const append = [&]( daw::string_view const part ) {
+					if( !part.empty( ) ) {
+						out[count++] = io_segment{part.data( ), part.size( )};
+					}
+				};
+				for( size_t n = 0; n < m_edit_count; ++n ) {
+					auto const &edit = m_edits[n];
+					append( m_head.substr( pos, edit.first - pos ) );
+					for( size_t p = 0; p < edit.part_count; ++p ) {
+						append( edit.parts[p] );
+					}
+					pos = edit.last;
+				}
+				append( m_head.substr( pos ) );
+				return count;
+			}
+
+			// Size of the rewritten head
+			size_t size( ) const noexcept {
+				size_t result = m_head.size( );
+				for( size_t n = 0; n < m_edit_count; ++n ) {
+					result -= m_edits[n].last - m_edits[n].first;
+					for( size_t p = 0; p < m_edits[n].part_count; ++p ) {
+						result += m_edits[n].parts[p].size( );
+					}
+				}
+				return result;
+			}
+
+			// Copy the rewritten head into buffer.  Returns the size written, 0 when capacity is too small
+			size_t write( char *buffer, size_t const capacity ) const noexcept {
+				auto const total = size( );
+				if( total > capacity ) {
+					return 0;
+				}
+				std::array<io_segment, max_segments> segs{};
+				auto const count = segments( segs );
+				for( size_t n = 0; n < count; ++n ) {
+					std::memcpy( buffer, segs[n].data, segs[n].size );
+					buffer += segs[n].size;
+				}
+				return total;
+			}
+
+#if defined( __unix__ ) || defined( __APPLE__ )
+			// Segments as iovecs ready for writev/sendmsg.  Returns the count used
+			size_t segments( std::array<iovec, max_segments> &out ) const noexcept {
+				std::array<io_segment, max_segments> segs{};
+				auto const count = segments( segs );
+				for( size_t n = 0; n < count; ++n ) {
+					out[n].iov_base = const_cast<char *>( segs[n].data );
+					out[n].iov_len = segs[n].size;
+				}
+				return count;
+			}
+#endif
+		};
+
+		using http_request_writer = basic_http_request_writer<>;
+	} // namespace http
+} // namespace daw
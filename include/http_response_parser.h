@@ -0,0 +1,93 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2017 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <daw/daw_parser_helper.h>
+#include <daw/daw_string_view.h>
+
+#include "daw_swar.h"
+#include "http_headers.h"
+#include "http_req_parser.h"
+
+namespace daw {
+	namespace http {
+		struct http_response {
+			http_version version;
+			uint16_t status;
+			daw::string_view reason;
+			known_header_set headers_present;
+		};
+
+		struct http_status_code {};
+
+		// Exactly 3 digits, 100-999.  The digits are checked and combined from a single word
+		CONSTEXPR uint16_t parse_to_value( daw::string_view const str, http_status_code ) {
+			if( str.size( ) != 3 ) {
+				throw daw::parser::invalid_input_exception{};
+			}
+			uint64_t const word = daw::swar::load( str.data( ), 3 );
+			uint64_t const required = daw::swar::hi_bits & daw::swar::prefix_mask( 3 );
+			if( ( daw::swar::digits( word ) & required ) != required || str[0] == '0' ) {
+				throw daw::parser::invalid_input_exception{};
+			}
+			uint64_t const values = word & daw::swar::broadcast( 0x0F );
+			return static_cast<uint16_t>( ( values & 0xFFU ) * 100U + ( ( values >> 8 ) & 0xFFU ) * 10U +
+			                              ( ( values >> 16 ) & 0xFFU ) );
+		}
+
+		// status-line = HTTP-version SP status-code SP reason-phrase.  A missing reason-phrase, with or without the
+		// space, is accepted
+		CONSTEXPR http_response parse_to_value( daw::string_view str, http_response ) {
+			if( str.size( ) < 12 || str[8] != ' ' || ( str.size( ) > 12 && str[12] != ' ' ) ) {
+				throw daw::parser::invalid_input_exception{};
+			}
+			http_response result{parse_to_value( str.substr( 0, 8 ), http_version{} ),
+			                     parse_to_value( str.substr( 9, 3 ), http_status_code{} ), daw::string_view{},
+			                     known_header_set{0}};
+			if( str.size( ) > 13 ) {
+				result.reason = str.substr( 13 );
+			}
+			return result;
+		}
+
+		// Parse the status line and the header block.  Returns the number of characters used or 0 when the head
+		// has not been completely received yet
+		inline size_t parse_response_head( daw::string_view const str, http_response &response,
+		                                   http_header_index &headers ) {
+			auto const line_end = impl::find_line_end( str, 0 );
+			if( line_end == daw::string_view::npos ) {
+				return 0;
+			}
+			auto const header_size = parse_headers( str.substr( line_end + 2 ), headers );
+			if( header_size == 0 ) {
+				return 0;
+			}
+			response = parse_to_value( str.substr( 0, line_end ), http_response{} );
+			response.headers_present = headers.present( );
+			return line_end + 2 + header_size;
+		}
+	} // namespace http
+} // namespace daw
@@ -0,0 +1,226 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2017 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include <daw/daw_parser_helper.h>
+#include <daw/daw_string_view.h>
+
+#include "daw_swar.h"
+#include "hex_digits.h"
+
+namespace daw {
+	namespace http {
+		namespace impl {
+			struct utf8_words {
+				// leading bytes that are whole, valid sequences
+				size_t valid;
+				// bytes looked at, the first invalid byte is within them when the check stopped early
+				size_t checked;
+			};
+
+			// Check the whole 8 byte words at the start of str, which must not start inside a sequence.  Each lead byte
+			// needs the continuation bytes it announces right after it, also across words, and each continuation byte
+			// needs a lead.  Lead bytes that narrow the range of the next byte( E0, ED, F0, F4 ) and bytes that never
+			// occur( C0, C1, F5-FF ) stop the check like any other mismatch, push( uint8_t ) sorts those out
+			constexpr utf8_words utf8_check_words( daw::string_view const str ) noexcept {
+				utf8_words result{0, 0};
+				// continuation bytes owed to the next word by sequences that start in this one
+				uint64_t carry = 0;
+				while( str.size( ) - result.checked >= 8 ) {
+					uint64_t const word = daw::swar::load( str.data( ) + result.checked, 8 );
+					result.checked += 8;
+					uint64_t const hi = word & daw::swar::hi_bits;
+					if( hi == 0 && carry == 0 ) {
+						result.valid = result.checked;
+						continue;
+					}
+					// bits 6, 5 and 4 of each byte moved to its high bit
+					uint64_t const b6 = ( word << 1U ) & daw::swar::hi_bits;
+					uint64_t const b5 = ( word << 2U ) & daw::swar::hi_bits;
+					uint64_t const b4 = ( word << 3U ) & daw::swar::hi_bits;
+					uint64_t const continuation = hi & ~b6;
+					uint64_t const lead = hi & b6;
+					uint64_t const lead34 = lead & b5;
+					uint64_t const lead4 = lead34 & b4;
+					// compared in their low 7 bits, F4-FF are those of at least 0x74
+					uint64_t const low7 = word & ~daw::swar::hi_bits;
+					uint64_t const special =
+					  lead & ( daw::swar::bytes_between( low7, 0x40, 0x41 ) | daw::swar::bytes_equal( low7, 0x60 ) |
+					           daw::swar::bytes_equal( low7, 0x6D ) | daw::swar::bytes_equal( low7, 0x70 ) |
+					           ( ( low7 + daw::swar::lo_bits * 0x0CU ) & daw::swar::hi_bits ) );
+					if( special != 0 || continuation != ( carry | ( lead << 8U ) | ( lead34 << 16U ) | ( lead4 << 24U ) ) ) {
+						return result;
+					}
+					carry = ( lead >> 56U ) | ( lead34 >> 48U ) | ( lead4 >> 40U );
+					if( carry == 0 ) {
+						result.valid = result.checked;
+					}
+				}
+				return result;
+			}
+		} // namespace impl
+
+		// Checks UTF-8 so that it can follow another pass, like percent decoding, over the same bytes.  Runs are
+		// checked a word at a time where possible.  Overlong forms, surrogates and code points past U+10FFFF are invalid
+		struct utf8_validator {
+		private:
+			size_t m_offset;
+			size_t m_sequence_start;
+			uint8_t m_remaining;
+			// range of the next continuation byte, only the first one after the lead byte is narrower than 80-BF
+			uint8_t m_lower;
+			uint8_t m_upper;
+
+		public:
+			constexpr utf8_validator( ) noexcept
+			  : m_offset{0}, m_sequence_start{0}, m_remaining{0}, m_lower{0x80}, m_upper{0xBF} {}
+
+			// false when b makes the input invalid, the sequence it belongs to starts at error_offset( )
+			constexpr bool push( uint8_t const b ) noexcept {
+				if( m_remaining != 0 ) {
+					if( b < m_lower || b > m_upper ) {
+						return false;
+					}
+					--m_remaining;
+					m_lower = 0x80;
+					m_upper = 0xBF;
+					++m_offset;
+					return true;
+				}
+				m_sequence_start = m_offset;
+				if( b < 0x80 ) {
+					++m_offset;
+					return true;
+				}
+				if( b < 0xC2 || b > 0xF4 ) {
+					return false;
+				}
+				if( b < 0xE0 ) {
+					m_remaining = 1;
+				} else if( b < 0xF0 ) {
+					m_remaining = 2;
+					if( b == 0xE0 ) {
+						m_lower = 0xA0;
+					} else if( b == 0xED ) {
+						m_upper = 0x9F;
+					}
+				} else {
+					m_remaining = 3;
+					if( b == 0xF0 ) {
+						m_lower = 0x90;
+					} else if( b == 0xF4 ) {
+						m_upper = 0x8F;
+					}
+				}
+				++m_offset;
+				return true;
+			}
+
+			// Check a run of bytes.  Between sequences whole words are checked at once by impl::utf8_check_words, ASCII
+			// and multibyte text alike.  Where that stops push( uint8_t ) takes over until past the word it stopped in
+			constexpr bool push( daw::string_view const str ) noexcept {
+				size_t pos = 0;
+				size_t bytewise_until = 0;
+				while( pos < str.size( ) ) {
+					if( m_remaining == 0 && pos >= bytewise_until ) {
+						auto const words = impl::utf8_check_words( str.substr( pos ) );
+						bytewise_until = pos + words.checked;
+						pos += words.valid;
+						m_offset += words.valid;
+						if( pos == str.size( ) ) {
+							break;
+						}
+					}
+					if( !push( static_cast<uint8_t>( str[pos] ) ) ) {
+						return false;
+					}
+					++pos;
+				}
+				return true;
+			}
+
+			// true when the input did not end inside a sequence
+			constexpr bool complete( ) const noexcept {
+				return m_remaining == 0;
+			}
+
+			// Start of the sequence that failed, or of the one left incomplete
+			constexpr size_t error_offset( ) const noexcept {
+				return m_sequence_start;
+			}
+		};
+
+		// Offset of the first byte of the first invalid or incomplete UTF-8 sequence in str, npos when all of it is
+		// valid.  e.g. utf8_first_invalid( req.uri.path ) after it has been decoded
+		constexpr size_t utf8_first_invalid( daw::string_view const str ) noexcept {
+			utf8_validator validator{};
+			if( !validator.push( str ) || !validator.complete( ) ) {
+				return validator.error_offset( );
+			}
+			return daw::string_view::npos;
+		}
+
+		struct percent_decode_result {
+			size_t size;
+			// offset in the decoded output of the first invalid UTF-8 sequence, npos when it is valid
+			size_t invalid_utf8_offset;
+		};
+
+		// Percent decode encoded into out, which needs room for encoded.size( ) characters, and check that the
+		// result is UTF-8 in the same pass.  Runs without escapes are checked and copied in bulk.  Escapes are read
+		// like percent_decode_iterator does and a bad one throws.  Decoding continues after invalid UTF-8
+		inline percent_decode_result percent_decode_utf8( daw::string_view const encoded, char *const out ) {
+			utf8_validator validator{};
+			bool valid = true;
+			size_t out_pos = 0;
+			size_t pos = 0;
+			while( pos < encoded.size( ) ) {
+				auto const pct = daw::swar::find( encoded, '%', pos );
+				auto const end = pct == daw::string_view::npos ? encoded.size( ) : pct;
+				auto const run = encoded.substr( pos, end - pos );
+				valid = valid && validator.push( run );
+				std::memcpy( out + out_pos, run.data( ), run.size( ) );
+				out_pos += run.size( );
+				pos = end;
+				if( pos == encoded.size( ) ) {
+					break;
+				}
+				if( encoded.size( ) - pos < 3 || !impl::is_hex_digit( encoded[pos + 1] ) ||
+				    !impl::is_hex_digit( encoded[pos + 2] ) ) {
+					throw daw::parser::invalid_input_exception{};
+				}
+				auto const b =
+				  static_cast<uint8_t>( ( impl::hex_value( encoded[pos + 1] ) << 4 ) | impl::hex_value( encoded[pos + 2] ) );
+				valid = valid && validator.push( b );
+				out[out_pos++] = static_cast<char>( b );
+				pos += 3;
+			}
+			valid = valid && validator.complete( );
+			return percent_decode_result{out_pos, valid ? daw::string_view::npos : validator.error_offset( )};
+		}
+	} // namespace http
+} // namespace daw
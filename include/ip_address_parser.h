@@ -0,0 +1,195 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2017 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <daw/daw_string_view.h>
+
+#include "daw_swar.h"
+#include "hex_digits.h"
+
+namespace daw {
+	namespace http {
+		enum class host_type : uint_fast8_t { reg_name = 0, ipv4, ipv6 };
+
+		// Octets are in network order, ::1 has octets[15] == 1
+		struct ipv6_address {
+			uint8_t octets[16];
+		};
+
+		// Binary form of the host.  ipv4 is in host byte order so that 127.0.0.1 is 0x7F00'0001 and masks can be
+		// applied directly
+		struct http_host_address {
+			host_type type;
+			uint32_t ipv4;
+			ipv6_address ipv6;
+		};
+
+		struct ipv4_parse_result {
+			uint32_t address;
+			size_t size;
+			bool found;
+
+			explicit constexpr operator bool( ) const noexcept {
+				return found;
+			}
+		};
+
+		struct ipv6_parse_result {
+			ipv6_address address;
+			bool found;
+
+			explicit constexpr operator bool( ) const noexcept {
+				return found;
+			}
+		};
+
+		namespace impl {
+			constexpr uint32_t lane( uint64_t const ( &words )[2], size_t const n ) noexcept {
+				return static_cast<uint32_t>( ( words[n / 8] >> ( 8 * ( n % 8 ) ) ) & 0xFFU );
+			}
+		} // namespace impl
+
+		// Parse a dotted quad( 1-3 digits per octet, no leading zeros ) from the front of str.  The 16 bytes that
+		// can hold an address are classified as digit/dot in two words and the octets are found from the dot mask.
+		// The caller decides whether the character following the address is acceptable
+		constexpr ipv4_parse_result parse_ipv4_prefix( daw::string_view const str ) noexcept {
+			ipv4_parse_result const failed{0, 0, false};
+			uint64_t const w0 = daw::swar::load( str );
+			uint64_t const w1 = str.size( ) > 8 ? daw::swar::load( str.substr( 8 ) ) : 0;
+			uint64_t const dots0 = daw::swar::bytes_equal( w0, '.' );
+			uint64_t const dots1 = daw::swar::bytes_equal( w1, '.' );
+
+			size_t len = daw::swar::leading_set_bytes( daw::swar::digits( w0 ) | dots0 );
+			if( len == 8 ) {
+				len += daw::swar::leading_set_bytes( daw::swar::digits( w1 ) | dots1 );
+			}
+			if( len < 7 || len > 15 ) {
+				return failed;
+			}
+			// Digit values in every lane, only the digit lanes are read below
+			uint64_t const v[2] = {w0 & daw::swar::broadcast( 0x0F ), w1 & daw::swar::broadcast( 0x0F )};
+
+			uint64_t dot_mask[2] = {dots0 & daw::swar::prefix_mask( len ),
+			                        len > 8 ? dots1 & daw::swar::prefix_mask( len - 8 ) : 0};
+			uint32_t result = 0;
+			size_t start = 0;
+			for( size_t octet = 0; octet < 4; ++octet ) {
+				size_t end = len;
+				if( octet < 3 ) {
+					size_t const word = dot_mask[0] != 0 ? 0 : 1;
+					if( dot_mask[word] == 0 ) {
+						return failed;
+					}
+					end = word * 8 + daw::swar::first_set_byte( dot_mask[word] );
+					dot_mask[word] &= dot_mask[word] - 1;
+				} else if( dot_mask[0] != 0 || dot_mask[1] != 0 ) {
+					return failed;
+				}
+				size_t const width = end - start;
+				if( width == 0 || width > 3 || ( width > 1 && impl::lane( v, start ) == 0 ) ) {
+					return failed;
+				}
+				uint32_t value = 0;
+				for( size_t n = start; n < end; ++n ) {
+					value = value * 10 + impl::lane( v, n );
+				}
+				if( value > 255 ) {
+					return failed;
+				}
+				result = ( result << 8 ) | value;
+				start = end + 1;
+			}
+			return ipv4_parse_result{result, len, true};
+		}
+
+		// Parse the text of an IPv6 literal, without the surrounding brackets.  All of str must be consumed. Zone
+		// identifiers are not accepted
+		constexpr ipv6_parse_result parse_ipv6( daw::string_view str ) noexcept {
+			ipv6_parse_result const failed{{}, false};
+			uint16_t groups[8] = {};
+			size_t count = 0;
+			size_t gap = 8;
+			if( str.size( ) >= 2 && str[0] == ':' && str[1] == ':' ) {
+				gap = 0;
+				str.remove_prefix( 2 );
+			} else if( str.empty( ) || str.front( ) == ':' ) {
+				return failed;
+			}
+			while( !str.empty( ) ) {
+				if( count == 8 ) {
+					return failed;
+				}
+				size_t const width = daw::swar::leading_set_bytes( impl::hex_digits( daw::swar::load( str ) ) );
+				if( width == 0 || width > 4 ) {
+					return failed;
+				}
+				if( width < str.size( ) && str[width] == '.' ) {
+					// trailing dotted quad, e.g. ::ffff:10.0.0.1
+					auto const ipv4 = parse_ipv4_prefix( str );
+					if( !ipv4 || ipv4.size != str.size( ) || count > 6 ) {
+						return failed;
+					}
+					groups[count++] = static_cast<uint16_t>( ipv4.address >> 16 );
+					groups[count++] = static_cast<uint16_t>( ipv4.address & 0xFFFFU );
+					str.clear( );
+					break;
+				}
+				uint16_t value = 0;
+				for( size_t n = 0; n < width; ++n ) {
+					value = static_cast<uint16_t>( ( value << 4 ) | impl::hex_value( str[n] ) );
+				}
+				groups[count++] = value;
+				str.remove_prefix( width );
+				if( str.empty( ) ) {
+					break;
+				}
+				if( str.front( ) != ':' ) {
+					return failed;
+				}
+				str.remove_prefix( );
+				if( !str.empty( ) && str.front( ) == ':' ) {
+					if( gap != 8 ) {
+						return failed;
+					}
+					gap = count;
+					str.remove_prefix( );
+				} else if( str.empty( ) ) {
+					return failed;
+				}
+			}
+			if( ( gap == 8 && count != 8 ) || ( gap != 8 && count > 7 ) ) {
+				return failed;
+			}
+			ipv6_parse_result result{{}, true};
+			for( size_t n = 0; n < count; ++n ) {
+				size_t const pos = ( gap != 8 && n >= gap ) ? n + ( 8 - count ) : n;
+				result.address.octets[2 * pos] = static_cast<uint8_t>( groups[n] >> 8 );
+				result.address.octets[2 * pos + 1] = static_cast<uint8_t>( groups[n] & 0xFFU );
+			}
+			return result;
+		}
+	} // namespace http
+} // namespace daw
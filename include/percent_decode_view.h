@@ -27,6 +27,8 @@
 #include <daw/daw_exception.h>
 #include <daw/daw_parser_helper.h>
 
+#include "hex_digits.h"
+
 namespace daw {
 	template<typename BidirectionalIterator,
 	         typename CharT = typename std::iterator_traits<BidirectionalIterator>::value_type>
@@ -43,16 +45,10 @@ namespace daw {
 		iterator m_first;
 
 		static constexpr char decode_digit( char b ) {
-			if( '0' <= b && b <= '9' ) {
-				return static_cast<value_type>( b - '0' );
-			}
-			if( 'A' <= b && b <= 'F' ) {
-				return static_cast<value_type>( (b - 'A') + 10 );
-			}
-			if( 'a' <= b && b <= 'f' ) {
-				return static_cast<value_type>( (b - 'a') + 10 );
+			if( !http::impl::is_hex_digit( b ) ) {
+				daw::exception::daw_throw( "Expected hex digit but item is out of range for hex" );
 			}
-			daw::exception::daw_throw( "Expected hex digit but item is out of range for hex" );
+			return static_cast<value_type>( http::impl::hex_value( b ) );
 		}
 
 		static constexpr char decode_digits( char hb, char lb ) {
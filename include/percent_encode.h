@@ -0,0 +1,125 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2017 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include <daw/daw_string_view.h>
+
+#include "daw_swar.h"
+#include "hex_digits.h"
+
+namespace daw {
+	namespace impl {
+		// Which characters CharClass leaves as is.  It is built from CharClass::check( char ), the same test the
+		// parser uses, so encoded text always parses and decodes back.  '%' is never left as is
+		struct percent_encode_table {
+			bool safe[256];
+			// every letter and digit is safe, so words made of them can be copied 8 at a time
+			bool alnum_safe;
+		};
+
+		template<typename CharClass>
+		percent_encode_table make_percent_encode_table( ) noexcept {
+			percent_encode_table result{};
+			for( size_t n = 0; n < 256; ++n ) {
+				auto const c = static_cast<char>( n );
+				result.safe[n] = c != '%' && CharClass::check( c );
+			}
+			result.alnum_safe = true;
+			for( size_t n = 0; n < 256; ++n ) {
+				bool const alnum = ( '0' <= n && n <= '9' ) || ( 'a' <= n && n <= 'z' ) || ( 'A' <= n && n <= 'Z' );
+				if( alnum && !result.safe[n] ) {
+					result.alnum_safe = false;
+				}
+			}
+			return result;
+		}
+
+		template<typename CharClass>
+		percent_encode_table const &get_percent_encode_table( ) noexcept {
+			static percent_encode_table const table = make_percent_encode_table<CharClass>( );
+			return table;
+		}
+
+		// true when all of the first count characters of word are letters or digits
+		constexpr bool is_alnum_word( uint64_t const word, size_t const count ) noexcept {
+			uint64_t const required = daw::swar::prefix_mask( count ) & daw::swar::hi_bits;
+			uint64_t const alnum = daw::swar::digits( word ) | daw::swar::bytes_between( word, 'a', 'z' ) |
+			                       daw::swar::bytes_between( word, 'A', 'Z' );
+			return ( alnum & required ) == required;
+		}
+	} // namespace impl
+
+	// Size of str once every character that CharClass does not allow has been percent encoded
+	template<typename CharClass>
+	size_t percent_encoded_size( daw::string_view const str ) noexcept {
+		auto const &table = impl::get_percent_encode_table<CharClass>( );
+		size_t result = str.size( );
+		size_t pos = 0;
+		while( pos < str.size( ) ) {
+			size_t const count = str.size( ) - pos < 8 ? str.size( ) - pos : 8;
+			if( table.alnum_safe && impl::is_alnum_word( daw::swar::load( str.data( ) + pos, count ), count ) ) {
+				pos += count;
+				continue;
+			}
+			for( size_t const last = pos + count; pos < last; ++pos ) {
+				if( !table.safe[static_cast<uint8_t>( str[pos] )] ) {
+					result += 2;
+				}
+			}
+		}
+		return result;
+	}
+
+	// Percent encode str into out, which must have room for percent_encoded_size<CharClass>( str ) characters.
+	// e.g. percent_encode<daw::http::char_sets::xalpha>( value, buffer ).  Returns the size written
+	template<typename CharClass>
+	size_t percent_encode( daw::string_view const str, char *const out ) noexcept {
+		auto const &table = impl::get_percent_encode_table<CharClass>( );
+		size_t out_pos = 0;
+		size_t pos = 0;
+		while( pos < str.size( ) ) {
+			size_t const count = str.size( ) - pos < 8 ? str.size( ) - pos : 8;
+			if( table.alnum_safe && impl::is_alnum_word( daw::swar::load( str.data( ) + pos, count ), count ) ) {
+				std::memcpy( out + out_pos, str.data( ) + pos, count );
+				out_pos += count;
+				pos += count;
+				continue;
+			}
+			for( size_t const last = pos + count; pos < last; ++pos ) {
+				auto const c = static_cast<uint8_t>( str[pos] );
+				if( table.safe[c] ) {
+					out[out_pos++] = str[pos];
+				} else {
+					out[out_pos++] = '%';
+					out[out_pos++] = http::impl::upper_hex_digit( static_cast<uint8_t>( c >> 4 ) );
+					out[out_pos++] = http::impl::upper_hex_digit( static_cast<uint8_t>( c & 0xFU ) );
+				}
+			}
+		}
+		return out_pos;
+	}
+} // namespace daw
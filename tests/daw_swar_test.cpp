@@ -0,0 +1,59 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2017 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <cstdint>
+#include <iostream>
+
+#define BOOST_TEST_MODULE swar
+#include <daw/boost_test.h>
+
+#include "daw_swar.h"
+
+BOOST_AUTO_TEST_CASE( daw_swar_parse_unsigned_test_001 ) {
+	BOOST_REQUIRE_EQUAL( daw::swar::parse_unsigned<uint16_t>( "0" ), 0 );
+	BOOST_REQUIRE_EQUAL( daw::swar::parse_unsigned<uint16_t>( "443" ), 443 );
+	BOOST_REQUIRE_EQUAL( daw::swar::parse_unsigned<uint16_t>( "65535" ), 65535 );
+	BOOST_REQUIRE_EQUAL( daw::swar::parse_unsigned<uint32_t>( "12345678" ), 12345678U );
+	BOOST_REQUIRE_EQUAL( daw::swar::parse_unsigned<uint32_t>( "4294967295" ), 4294967295U );
+	BOOST_REQUIRE_EQUAL( daw::swar::parse_unsigned<uint64_t>( "123456789012345678" ), 123456789012345678ULL );
+	BOOST_REQUIRE_EQUAL( daw::swar::parse_unsigned<uint64_t>( "18446744073709551615" ), 18446744073709551615ULL );
+}
+
+BOOST_AUTO_TEST_CASE( daw_swar_parse_unsigned_test_002 ) {
+	BOOST_REQUIRE_THROW( daw::swar::parse_unsigned<uint16_t>( "65536" ), daw::parser::numeric_overflow_exception );
+	BOOST_REQUIRE_THROW( daw::swar::parse_unsigned<uint16_t>( "11211:80" ), daw::parser::numeric_overflow_exception );
+	BOOST_REQUIRE_THROW( daw::swar::parse_unsigned<uint32_t>( "4294967296" ), daw::parser::numeric_overflow_exception );
+	BOOST_REQUIRE_THROW( daw::swar::parse_unsigned<uint64_t>( "18446744073709551616" ),
+	                     daw::parser::numeric_overflow_exception );
+	BOOST_REQUIRE_THROW( daw::swar::parse_unsigned<uint64_t>( "99999999999999999999" ),
+	                     daw::parser::numeric_overflow_exception );
+	BOOST_REQUIRE_THROW( daw::swar::parse_unsigned<uint64_t>( "184467440737095516150" ),
+	                     daw::parser::numeric_overflow_exception );
+}
+
+BOOST_AUTO_TEST_CASE( daw_swar_parse_unsigned_test_003 ) {
+	BOOST_REQUIRE_THROW( daw::swar::parse_unsigned<uint16_t>( "" ), daw::parser::invalid_input_exception );
+	BOOST_REQUIRE_THROW( daw::swar::parse_unsigned<uint16_t>( "8a" ), daw::parser::invalid_input_exception );
+	BOOST_REQUIRE_THROW( daw::swar::parse_unsigned<uint16_t>( ":80" ), daw::parser::invalid_input_exception );
+	BOOST_REQUIRE_THROW( daw::swar::parse_unsigned<uint64_t>( "1234567/90" ), daw::parser::invalid_input_exception );
+	BOOST_REQUIRE_THROW( daw::swar::parse_unsigned<uint64_t>( "-1" ), daw::parser::invalid_input_exception );
+}
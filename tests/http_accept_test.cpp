@@ -0,0 +1,112 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2017 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#define BOOST_TEST_MODULE http_accept
+#include <daw/boost_test.h>
+
+#include "http_accept.h"
+
+namespace {
+	constexpr size_t npos = daw::string_view::npos;
+
+	constexpr auto const media_offers =
+	  daw::http::make_offer_list( daw::http::http_list_kind::media_type, "application/json", "text/html", "text/plain" );
+	constexpr auto const encoding_offers =
+	  daw::http::make_offer_list( daw::http::http_list_kind::encoding, "br", "gzip", "identity" );
+	constexpr auto const gzip_offers =
+	  daw::http::make_offer_list( daw::http::http_list_kind::encoding, "gzip", "identity" );
+	constexpr auto const gzip_only_offers = daw::http::make_offer_list( daw::http::http_list_kind::encoding, "gzip" );
+	constexpr auto const charset_offers =
+	  daw::http::make_offer_list( daw::http::http_list_kind::token, "utf-8", "latin1" );
+	constexpr auto const language_offers =
+	  daw::http::make_offer_list( daw::http::http_list_kind::language, "en-US", "fr-CA", "de" );
+} // namespace
+
+BOOST_AUTO_TEST_CASE( daw_qvalue_test_001 ) {
+	BOOST_REQUIRE_EQUAL( daw::http::impl::parse_qvalue( "1" ), 1000 );
+	BOOST_REQUIRE_EQUAL( daw::http::impl::parse_qvalue( "1.000" ), 1000 );
+	BOOST_REQUIRE_EQUAL( daw::http::impl::parse_qvalue( "0" ), 0 );
+	BOOST_REQUIRE_EQUAL( daw::http::impl::parse_qvalue( "0." ), 0 );
+	BOOST_REQUIRE_EQUAL( daw::http::impl::parse_qvalue( "0.5" ), 500 );
+	BOOST_REQUIRE_EQUAL( daw::http::impl::parse_qvalue( "0.25" ), 250 );
+	BOOST_REQUIRE_EQUAL( daw::http::impl::parse_qvalue( "0.001" ), 1 );
+	BOOST_REQUIRE_EQUAL( daw::http::impl::parse_qvalue( "1.5" ), daw::http::impl::invalid_qvalue );
+	BOOST_REQUIRE_EQUAL( daw::http::impl::parse_qvalue( "2" ), daw::http::impl::invalid_qvalue );
+	BOOST_REQUIRE_EQUAL( daw::http::impl::parse_qvalue( "0.0001" ), daw::http::impl::invalid_qvalue );
+	BOOST_REQUIRE_EQUAL( daw::http::impl::parse_qvalue( "0,5" ), daw::http::impl::invalid_qvalue );
+	BOOST_REQUIRE_EQUAL( daw::http::impl::parse_qvalue( ".5" ), daw::http::impl::invalid_qvalue );
+	BOOST_REQUIRE_EQUAL( daw::http::impl::parse_qvalue( "" ), daw::http::impl::invalid_qvalue );
+}
+
+BOOST_AUTO_TEST_CASE( daw_weighted_list_test_001 ) {
+	std::vector<daw::http::http_weighted_item> items{};
+	for( auto const &item :
+	     daw::http::make_weighted_list_view( "text/html;level=\"1,2\";q=0.5;ext, , */*;q=bad,application/json" ) ) {
+		items.push_back( item );
+	}
+	BOOST_REQUIRE_EQUAL( items.size( ), 2 );
+	BOOST_REQUIRE_EQUAL( items[0].value, "text/html" );
+	BOOST_REQUIRE_EQUAL( items[0].params, "level=\"1,2\"" );
+	BOOST_REQUIRE_EQUAL( items[0].q, 500 );
+	BOOST_REQUIRE_EQUAL( items[1].value, "application/json" );
+	BOOST_REQUIRE_EQUAL( items[1].params, "" );
+	BOOST_REQUIRE_EQUAL( items[1].q, 1000 );
+}
+
+BOOST_AUTO_TEST_CASE( daw_negotiate_test_001 ) {
+	BOOST_REQUIRE_EQUAL( daw::http::negotiate( "", media_offers ), 0 );
+	BOOST_REQUIRE_EQUAL( daw::http::negotiate( "text/html, application/json;q=0.9", media_offers ), 1 );
+	BOOST_REQUIRE_EQUAL( daw::http::negotiate( "text/*;q=0.8, */*;q=0.1", media_offers ), 1 );
+	// The more specific range wins even with a lower weight
+	BOOST_REQUIRE_EQUAL( daw::http::negotiate( "text/*, text/html;q=0.2, text/plain;q=0.3", media_offers ), 2 );
+	BOOST_REQUIRE_EQUAL( daw::http::negotiate( "*/*, application/json;q=0", media_offers ), 1 );
+	BOOST_REQUIRE_EQUAL( daw::http::negotiate( "image/png", media_offers ), npos );
+	BOOST_REQUIRE_EQUAL( daw::http::negotiate( "TEXT/PLAIN", media_offers ), 2 );
+
+	BOOST_REQUIRE_EQUAL( daw::http::negotiate( "gzip, deflate, br;q=0.9", encoding_offers ), 1 );
+	BOOST_REQUIRE_EQUAL( daw::http::negotiate( "*;q=0.5, gzip;q=0", encoding_offers ), 0 );
+	BOOST_REQUIRE_EQUAL( daw::http::negotiate( "deflate", encoding_offers ), 2 );
+
+	// identity is acceptable unless excluded, but loses to any coding that was asked for
+	BOOST_REQUIRE_EQUAL( daw::http::negotiate( "", gzip_offers ), 1 );
+	BOOST_REQUIRE_EQUAL( daw::http::negotiate( "br", gzip_offers ), 1 );
+	BOOST_REQUIRE_EQUAL( daw::http::negotiate( "gzip;q=0", gzip_offers ), 1 );
+	BOOST_REQUIRE_EQUAL( daw::http::negotiate( "gzip;q=0.1", gzip_offers ), 0 );
+	BOOST_REQUIRE_EQUAL( daw::http::negotiate( "identity;q=0, br", gzip_offers ), npos );
+	BOOST_REQUIRE_EQUAL( daw::http::negotiate( "*;q=0", gzip_offers ), npos );
+	BOOST_REQUIRE_EQUAL( daw::http::negotiate( "*;q=0, identity", gzip_offers ), 1 );
+	BOOST_REQUIRE_EQUAL( daw::http::negotiate( "", gzip_only_offers ), npos );
+	static_assert( daw::http::negotiate( "br", gzip_offers ) == 1, "" );
+
+	// Other token lists have no implicit value, an empty header accepts anything
+	BOOST_REQUIRE_EQUAL( daw::http::negotiate( "", charset_offers ), 0 );
+	BOOST_REQUIRE_EQUAL( daw::http::negotiate( "latin1", charset_offers ), 1 );
+	BOOST_REQUIRE_EQUAL( daw::http::negotiate( "ascii", charset_offers ), npos );
+
+	BOOST_REQUIRE_EQUAL( daw::http::negotiate( "fr, en;q=0.8", language_offers ), 1 );
+	BOOST_REQUIRE_EQUAL( daw::http::negotiate( "en-us;q=0.5, de;q=0.6", language_offers ), 2 );
+	BOOST_REQUIRE_EQUAL( daw::http::negotiate( "e", language_offers ), npos );
+}
@@ -0,0 +1,230 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2017 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <algorithm>
+#include <deque>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#define BOOST_TEST_MODULE http_async_parser
+#include <daw/boost_test.h>
+
+#include "http_async_parser.h"
+
+BOOST_AUTO_TEST_CASE( daw_http_async_parser_test_001 ) {
+	std::string const head = "GET /a?b=1 HTTP/1.1\r\n"
+	                         "Host: example.com\r\n"
+	                         "Connection: close\r\n"
+	                         "\r\n";
+	daw::http::http_request_head_parser parser{};
+	for( size_t n = 1; n < head.size( ); ++n ) {
+		BOOST_REQUIRE_EQUAL( parser.parse( daw::string_view{head.data( ), n} ), 0 );
+	}
+	BOOST_REQUIRE_EQUAL( parser.parse( head ), head.size( ) );
+	BOOST_REQUIRE( parser.done( ) );
+	BOOST_REQUIRE( parser.request( ).method == daw::http::request_method::GET );
+	BOOST_REQUIRE_EQUAL( parser.request( ).uri.path, "/a" );
+	BOOST_REQUIRE_EQUAL( parser.headers( ).size( ), 2 );
+	BOOST_REQUIRE_EQUAL( parser.headers( )[daw::http::known_header::host], "example.com" );
+	BOOST_REQUIRE( parser.request( ).headers_present.contains( daw::http::known_header::connection ) );
+
+	parser.reset( );
+	BOOST_REQUIRE( !parser.done( ) );
+	BOOST_REQUIRE_THROW( parser.parse( "GET / HTTP/1.1\r\nHost: a\r\n\rx" ), daw::parser::invalid_input_exception );
+
+	// A long request line that arrives one byte at a time is scanned once, each call continues where the last stopped
+	std::string const long_line = "GET /" + std::string( 4000, 'a' ) + "?q=%41 HTTP/1.1\r\nHost: a\r\n\r\n";
+	parser.reset( );
+	for( size_t n = 1; n < long_line.size( ); ++n ) {
+		BOOST_REQUIRE_EQUAL( parser.parse( daw::string_view{long_line.data( ), n} ), 0 );
+	}
+	BOOST_REQUIRE_EQUAL( parser.parse( long_line ), long_line.size( ) );
+	BOOST_REQUIRE_EQUAL( parser.request( ).uri.path.size( ), 4001 );
+	BOOST_REQUIRE_EQUAL( parser.request( ).uri.query, "q=%41" );
+
+	daw::http::http_limits limits{};
+	limits.max_uri_component = 100;
+	daw::http::http_request_head_parser short_uri{limits};
+	for( size_t n = 1; n < 100; ++n ) {
+		BOOST_REQUIRE_EQUAL( short_uri.parse( daw::string_view{long_line.data( ), n} ), 0 );
+	}
+	BOOST_REQUIRE_THROW( short_uri.parse( daw::string_view{long_line.data( ), 200} ),
+	                     daw::http::http_limit_exceeded_exception );
+
+	limits = daw::http::http_limits{};
+	limits.max_header_bytes = 16;
+	daw::http::http_request_head_parser limited{limits};
+	BOOST_REQUIRE_EQUAL( limited.parse( "GET / HTTP/1.1\r\nHost: a\r\n" ), 0 );
+	BOOST_REQUIRE_THROW( limited.parse( "GET / HTTP/1.1\r\nHost: a\r\nX-Long: 01234" ),
+	                     daw::http::http_limit_exceeded_exception );
+
+	limits = daw::http::http_limits{};
+	limits.max_headers = 1000;
+	daw::http::http_request_head_parser many_headers{limits};
+	std::string many = "GET / HTTP/1.1\r\n";
+	for( size_t n = 0; n <= daw::http::http_header_index::capacity; ++n ) {
+		many += "X-" + std::to_string( n ) + ": v\r\n";
+	}
+	BOOST_REQUIRE_THROW( many_headers.parse( many ), daw::http::http_limit_exceeded_exception );
+}
+
+#ifdef DAW_HTTP_HAS_COROUTINES
+namespace {
+	// Hands out the input a few bytes at a time.  Reads complete inline or from run( ), like an event loop
+	struct test_source {
+		std::string data;
+		size_t pos = 0;
+		size_t chunk = 3;
+		bool complete_inline = false;
+		std::deque<std::function<void( )>> queue{};
+
+		template<typename Callback>
+		void async_read( char *buffer, size_t capacity, Callback on_read ) {
+			auto read = [this, buffer, capacity, on_read]( ) mutable {
+				size_t const count = std::min( {chunk, capacity, data.size( ) - pos} );
+				std::copy( data.data( ) + pos, data.data( ) + pos + count, buffer );
+				pos += count;
+				on_read( count );
+			};
+			if( complete_inline ) {
+				read( );
+			} else {
+				queue.push_back( read );
+			}
+		}
+
+		void run( ) {
+			while( !queue.empty( ) ) {
+				auto item = std::move( queue.front( ) );
+				queue.pop_front( );
+				item( );
+			}
+		}
+	};
+
+	struct detached_task {
+		struct promise_type {
+			detached_task get_return_object( ) noexcept {
+				return {};
+			}
+			std::suspend_never initial_suspend( ) noexcept {
+				return {};
+			}
+			std::suspend_never final_suspend( ) noexcept {
+				return {};
+			}
+			void return_void( ) noexcept {}
+			void unhandled_exception( ) {
+				throw;
+			}
+		};
+	};
+
+	// Records the path of each request and skips the bodies
+	template<typename Parser>
+	detached_task read_all( Parser &parser, test_source &source, std::vector<std::string> &paths, bool &finished ) {
+		// Not while( co_await ... ).  gcc 12.2 miscompiles a co_await in a loop condition, the resumed frame is
+		// corrupt.  A trivial awaiter that only stores the handle and is resumed from a queue fails the same way, so it
+		// is the compiler and not the lifetime of next_request_awaiter
+		while( true ) {
+			bool const found = co_await parser.next_request( source );
+			if( !found ) {
+				break;
+			}
+			paths.push_back( parser.request( ).uri.path.to_string( ) );
+			auto const length = parser.headers( )[daw::http::known_header::content_length];
+			if( !length.empty( ) ) {
+				parser.skip_body( daw::http::parse_to_value( length, daw::http::http_content_length{} ) );
+			}
+		}
+		finished = true;
+	}
+
+	void check_source( bool const complete_inline ) {
+		test_source source{};
+		source.data = "GET /one HTTP/1.1\r\nHost: a\r\n\r\n"
+		              "GET /two HTTP/1.1\r\nHost: b\r\n\r\n"
+		              "GET /three HTTP/1.1\r\n\r\n";
+		source.complete_inline = complete_inline;
+		auto parser = std::make_unique<daw::http::async_http_request_parser>( );
+		std::vector<std::string> paths{};
+		bool finished = false;
+		read_all( *parser, source, paths, finished );
+		source.run( );
+		BOOST_REQUIRE( finished );
+		BOOST_REQUIRE_EQUAL( paths.size( ), 3 );
+		BOOST_REQUIRE_EQUAL( paths[0], "/one" );
+		BOOST_REQUIRE_EQUAL( paths[1], "/two" );
+		BOOST_REQUIRE_EQUAL( paths[2], "/three" );
+	}
+} // namespace
+
+BOOST_AUTO_TEST_CASE( daw_http_async_parser_test_002 ) {
+	check_source( false );
+	check_source( true );
+}
+
+BOOST_AUTO_TEST_CASE( daw_http_async_parser_test_003 ) {
+	// Pipelined requests that arrive in one read are returned without waiting
+	test_source source{};
+	source.data = "GET /x HTTP/1.1\r\n\r\nGET /y HTTP/1.1\r\n\r\n";
+	source.chunk = source.data.size( );
+	auto parser = std::make_unique<daw::http::async_http_request_parser>( );
+	std::vector<std::string> paths{};
+	bool finished = false;
+	read_all( *parser, source, paths, finished );
+	source.run( );
+	BOOST_REQUIRE( finished );
+	BOOST_REQUIRE_EQUAL( paths.size( ), 2 );
+	BOOST_REQUIRE_EQUAL( paths[1], "/y" );
+}
+
+BOOST_AUTO_TEST_CASE( daw_http_async_parser_test_004 ) {
+	// A POST with a body followed by a GET on the same connection, the body is not taken for a request.  The second
+	// body is larger than the buffer
+	for( bool const complete_inline : {false, true} ) {
+		for( size_t const chunk : {size_t{3}, size_t{1000}} ) {
+			test_source source{};
+			source.data = "POST /upload HTTP/1.1\r\nContent-Length: 29\r\n\r\nGET /not-a-request HTTP/1.1\r\n"
+			              "GET /next HTTP/1.1\r\n\r\n"
+			              "POST /big HTTP/1.1\r\nContent-Length: 1000\r\n\r\n" +
+			              std::string( 1000, 'x' ) + "GET /last HTTP/1.1\r\n\r\n";
+			source.chunk = chunk;
+			source.complete_inline = complete_inline;
+			auto parser = std::make_unique<daw::http::basic_async_http_request_parser<256>>( );
+			std::vector<std::string> paths{};
+			bool finished = false;
+			read_all( *parser, source, paths, finished );
+			source.run( );
+			BOOST_REQUIRE( finished );
+			BOOST_REQUIRE_EQUAL( paths.size( ), 4 );
+			BOOST_REQUIRE_EQUAL( paths[0], "/upload" );
+			BOOST_REQUIRE_EQUAL( paths[1], "/next" );
+			BOOST_REQUIRE_EQUAL( paths[2], "/big" );
+			BOOST_REQUIRE_EQUAL( paths[3], "/last" );
+		}
+	}
+}
+#endif
@@ -0,0 +1,207 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2017 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <cstdio>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+#define BOOST_TEST_MODULE http_capture
+#include <daw/boost_test.h>
+
+#include "http_async_parser.h"
+#include "http_capture.h"
+
+namespace {
+	// A capture file in the working directory, removed afterwards
+	struct temp_capture {
+		std::string path;
+
+		temp_capture( ) : path{"daw_http_capture_test_" + std::to_string( ::getpid( ) ) + ".cap"} {}
+
+		~temp_capture( ) {
+			std::remove( path.c_str( ) );
+		}
+	};
+
+	std::string const stream_1 = "GET /a HTTP/1.1\r\nHost: a.test\r\n\r\n"
+	                             "GET /b HTTP/1.1\r\nHost: a.test\r\nAccept: */*\r\n\r\n";
+	std::string const stream_2 = "GET /c?x=1 HTTP/1.1\r\nHost: b.test\r\nUser-Agent: test\r\n\r\n";
+
+	// The two streams as interleaved reads that do not follow line boundaries
+	void write_streams( std::string const &path, bool const timestamps ) {
+		daw::http::http_capture_writer writer{path.c_str( ), timestamps};
+		writer.write( 1, daw::string_view{stream_1}.substr( 0, 20 ), 100 );
+		writer.write( 2, daw::string_view{stream_2}.substr( 0, 7 ), 200 );
+		writer.write( 1, daw::string_view{stream_1}.substr( 20, 30 ), 300 );
+		writer.write( 2, daw::string_view{stream_2}.substr( 7 ), 400 );
+		writer.write( 1, daw::string_view{}, 500 );
+		writer.write( 1, daw::string_view{stream_1}.substr( 50 ), 600 );
+	}
+
+	struct stream_state {
+		std::string buffer;
+		daw::http::http_request_head_parser parser;
+		std::vector<std::string> paths;
+
+		stream_state( ) : buffer{}, parser{}, paths{} {
+			// the parser needs the bytes to stay at the same address
+			buffer.reserve( 1024 );
+		}
+	};
+
+	// Replay the capture into one head parser per stream, returns the paths of the requests of each stream
+	std::map<uint32_t, std::vector<std::string>> parse_replay( daw::http::http_capture_reader const &capture,
+	                                                           daw::http::http_replay_policy const &policy ) {
+		std::map<uint32_t, stream_state> streams{};
+		daw::http::replay( capture, policy, [&]( daw::http::http_capture_record const &record, daw::string_view chunk ) {
+			auto &stream = streams[record.stream];
+			stream.buffer.append( chunk.data( ), chunk.size( ) );
+			while( auto const head_size = stream.parser.parse( stream.buffer ) ) {
+				stream.paths.push_back( stream.parser.request( ).uri.path.to_string( ) );
+				stream.buffer.erase( 0, head_size );
+				stream.parser.reset( );
+			}
+		} );
+		std::map<uint32_t, std::vector<std::string>> result{};
+		for( auto const &stream : streams ) {
+			BOOST_REQUIRE( stream.second.buffer.empty( ) );
+			result[stream.first] = stream.second.paths;
+		}
+		return result;
+	}
+} // namespace
+
+BOOST_AUTO_TEST_CASE( daw_http_capture_test_001 ) {
+	temp_capture const file{};
+	for( bool const timestamps : {true, false} ) {
+		write_streams( file.path, timestamps );
+		daw::http::http_capture_reader const capture{file.path.c_str( )};
+		BOOST_REQUIRE_EQUAL( capture.has_timestamps( ), timestamps );
+
+		std::map<uint32_t, std::string> joined{};
+		size_t count = 0;
+		uint64_t last_timestamp = 0;
+		for( auto const &record : capture ) {
+			joined[record.stream] += record.data.to_string( );
+			if( timestamps ) {
+				BOOST_REQUIRE_GT( record.timestamp_ns, last_timestamp );
+				last_timestamp = record.timestamp_ns;
+			} else {
+				BOOST_REQUIRE_EQUAL( record.timestamp_ns, 0U );
+			}
+			++count;
+		}
+		BOOST_REQUIRE_EQUAL( count, 6U );
+		BOOST_REQUIRE_EQUAL( joined[1], stream_1 );
+		BOOST_REQUIRE_EQUAL( joined[2], stream_2 );
+	}
+}
+
+BOOST_AUTO_TEST_CASE( daw_http_capture_test_002 ) {
+	// Records larger than the write buffer and the time based timestamps
+	temp_capture const file{};
+	std::string const large( 200 * 1024, 'x' );
+	{
+		daw::http::http_capture_writer writer{file.path.c_str( )};
+		for( uint32_t n = 0; n < 4; ++n ) {
+			writer.write( n, large );
+		}
+	}
+	daw::http::http_capture_reader const capture{file.path.c_str( )};
+	uint32_t stream = 0;
+	uint64_t last_timestamp = 0;
+	for( auto const &record : capture ) {
+		BOOST_REQUIRE_EQUAL( record.stream, stream++ );
+		BOOST_REQUIRE( record.data == large );
+		BOOST_REQUIRE_GE( record.timestamp_ns, last_timestamp );
+		last_timestamp = record.timestamp_ns;
+	}
+	BOOST_REQUIRE_EQUAL( stream, 4U );
+}
+
+BOOST_AUTO_TEST_CASE( daw_http_capture_test_003 ) {
+	temp_capture const file{};
+	write_streams( file.path, true );
+	daw::http::http_capture_reader const capture{file.path.c_str( )};
+	std::vector<std::string> const paths_1 = {"/a", "/b"};
+	std::vector<std::string> const paths_2 = {"/c"};
+
+	daw::http::http_replay_policy policy{};
+	for( auto const chunking : {daw::http::http_replay_chunking::original, daw::http::http_replay_chunking::fixed,
+	                            daw::http::http_replay_chunking::random} ) {
+		for( size_t const chunk_size : {1U, 3U, 64U} ) {
+			policy.chunking = chunking;
+			policy.chunk_size = chunk_size;
+			auto const paths = parse_replay( capture, policy );
+			BOOST_REQUIRE( paths.at( 1 ) == paths_1 );
+			BOOST_REQUIRE( paths.at( 2 ) == paths_2 );
+		}
+	}
+
+	// Chunk sizes follow the policy, random cuts repeat for the same seed
+	auto const chunk_sizes = [&]( daw::http::http_replay_policy const &p ) {
+		std::vector<size_t> result{};
+		daw::http::replay( capture, p, [&]( daw::http::http_capture_record const &, daw::string_view const chunk ) {
+			result.push_back( chunk.size( ) );
+		} );
+		return result;
+	};
+	policy.chunking = daw::http::http_replay_chunking::fixed;
+	policy.chunk_size = 8;
+	for( auto const size : chunk_sizes( policy ) ) {
+		BOOST_REQUIRE( size >= 1 && size <= 8 );
+	}
+	policy.chunking = daw::http::http_replay_chunking::random;
+	policy.seed = 42;
+	auto const random_sizes = chunk_sizes( policy );
+	BOOST_REQUIRE( random_sizes == chunk_sizes( policy ) );
+	policy.seed = 43;
+	BOOST_REQUIRE( random_sizes != chunk_sizes( policy ) );
+	policy.chunking = daw::http::http_replay_chunking::original;
+	BOOST_REQUIRE_EQUAL( chunk_sizes( policy ).size( ), 6U );
+}
+
+BOOST_AUTO_TEST_CASE( daw_http_capture_test_004 ) {
+	temp_capture const file{};
+	write_streams( file.path, false );
+	// cut the last record short
+	BOOST_REQUIRE_EQUAL( ::truncate( file.path.c_str( ), static_cast<off_t>( 16 + 8 * 6 + stream_1.size( ) +
+	                                                                         stream_2.size( ) - 1 ) ),
+	                     0 );
+	{
+		daw::http::http_capture_reader const capture{file.path.c_str( )};
+		auto it = capture.begin( );
+		for( size_t n = 0; n < 4; ++n ) {
+			++it;
+		}
+		BOOST_REQUIRE_THROW( ++it, daw::parser::invalid_input_exception );
+	}
+	{
+		daw::http::http_capture_writer writer{file.path.c_str( )};
+	}
+	BOOST_REQUIRE_EQUAL( ::truncate( file.path.c_str( ), 10 ), 0 );
+	BOOST_REQUIRE_THROW( daw::http::http_capture_reader{file.path.c_str( )}, daw::parser::invalid_input_exception );
+	BOOST_REQUIRE_THROW( daw::http::http_capture_reader{"/nonexistent/capture"}, std::system_error );
+}
@@ -0,0 +1,271 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2017 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#define BOOST_TEST_MODULE http_connection
+#include <daw/boost_test.h>
+
+#include "http_connection.h"
+
+namespace {
+	void send_all( int const fd, daw::string_view str ) {
+		while( !str.empty( ) ) {
+			auto const count = ::send( fd, str.data( ), str.size( ), MSG_NOSIGNAL );
+			BOOST_REQUIRE( count > 0 );
+			str.remove_prefix( static_cast<size_t>( count ) );
+		}
+	}
+
+	// A listening socket on an ephemeral loopback port, addr receives its address
+	int listen_loopback( sockaddr_in &addr ) {
+		int const listen_fd = ::socket( AF_INET, SOCK_STREAM, 0 );
+		BOOST_REQUIRE( listen_fd >= 0 );
+		addr = sockaddr_in{};
+		addr.sin_family = AF_INET;
+		addr.sin_addr.s_addr = htonl( INADDR_LOOPBACK );
+		addr.sin_port = 0;
+		BOOST_REQUIRE_EQUAL( ::bind( listen_fd, reinterpret_cast<sockaddr *>( &addr ), sizeof( addr ) ), 0 );
+		BOOST_REQUIRE_EQUAL( ::listen( listen_fd, 16 ), 0 );
+		socklen_t addr_len = sizeof( addr );
+		BOOST_REQUIRE_EQUAL( ::getsockname( listen_fd, reinterpret_cast<sockaddr *>( &addr ), &addr_len ), 0 );
+		return listen_fd;
+	}
+
+	std::string recv_all( int const fd ) {
+		std::string received( 256, '\0' );
+		size_t received_size = 0;
+		while( true ) {
+			auto const count = ::recv( fd, &received[received_size], received.size( ) - received_size, 0 );
+			if( count <= 0 ) {
+				break;
+			}
+			received_size += static_cast<size_t>( count );
+		}
+		received.resize( received_size );
+		return received;
+	}
+} // namespace
+
+BOOST_AUTO_TEST_CASE( daw_mirrored_buffer_test_001 ) {
+	daw::http::mirrored_buffer buffer{1};
+	auto const capacity = buffer.capacity( );
+	BOOST_REQUIRE( capacity > 0 );
+
+	// move the read position close to the end so the next write wraps
+	buffer.commit( capacity - 3 );
+	buffer.consume( capacity - 3 );
+	std::memcpy( buffer.write_position( ), "abcdef", 6 );
+	buffer.commit( 6 );
+	BOOST_REQUIRE_EQUAL( buffer.data( ), "abcdef" );
+}
+
+BOOST_AUTO_TEST_CASE( daw_http_connection_test_001 ) {
+	int fds[2];
+	BOOST_REQUIRE_EQUAL( ::socketpair( AF_UNIX, SOCK_STREAM, 0, fds ), 0 );
+	daw::http::http_connection connection{fds[0], 4096};
+
+	std::string const first = "POST /a HTTP/1.1\r\nHost: x\r\nContent-Length: 5\r\n\r\nhello";
+	std::string const second = "GET /b HTTP/1.1\r\nHost: x\r\nConnection: close\r\n\r\n";
+
+	send_all( fds[1], first.substr( 0, 20 ) );
+	BOOST_REQUIRE( connection.fill( ) );
+	BOOST_REQUIRE( !connection.next_request( ) );
+
+	send_all( fds[1], first.substr( 20 ) + second );
+	BOOST_REQUIRE( connection.fill( ) );
+	BOOST_REQUIRE( connection.next_request( ) );
+	BOOST_REQUIRE_EQUAL( connection.request( ).uri.path, "/a" );
+	BOOST_REQUIRE_EQUAL( connection.body( ), "hello" );
+	BOOST_REQUIRE( connection.keep_alive( ) );
+	connection.finish_request( );
+
+	BOOST_REQUIRE( connection.next_request( ) );
+	BOOST_REQUIRE_EQUAL( connection.request( ).uri.path, "/b" );
+	BOOST_REQUIRE( !connection.keep_alive( ) );
+	connection.finish_request( );
+	BOOST_REQUIRE( !connection.next_request( ) );
+
+	// Many requests through a one page buffer so that requests wrap around the end of the ring
+	for( size_t n = 0; n < 200; ++n ) {
+		send_all( fds[1], first );
+		BOOST_REQUIRE( connection.fill( ) );
+		BOOST_REQUIRE( connection.next_request( ) );
+		BOOST_REQUIRE_EQUAL( connection.body( ), "hello" );
+		connection.finish_request( );
+	}
+	// Every request after the first repeats the same header lines
+	BOOST_REQUIRE_EQUAL( connection.header_cache_counters( ).parsed, 4U );
+
+	::close( fds[1] );
+	BOOST_REQUIRE( !connection.fill( ) );
+}
+
+BOOST_AUTO_TEST_CASE( daw_http_connection_test_002 ) {
+	int fds[2];
+	BOOST_REQUIRE_EQUAL( ::socketpair( AF_UNIX, SOCK_STREAM, 0, fds ), 0 );
+	daw::http::http_connection connection{fds[0], 4096};
+
+	std::string const proxy = "PROXY TCP4 203.0.113.7 10.0.0.1 40000 80\r\n";
+	std::string const request = "GET /c HTTP/1.1\r\nHost: x\r\n\r\n";
+
+	send_all( fds[1], proxy.substr( 0, 10 ) );
+	BOOST_REQUIRE( connection.fill( ) );
+	BOOST_REQUIRE( !connection.read_proxy_header( ) );
+
+	send_all( fds[1], proxy.substr( 10 ) + request );
+	BOOST_REQUIRE( connection.fill( ) );
+	BOOST_REQUIRE( connection.read_proxy_header( ) );
+	BOOST_REQUIRE_EQUAL( connection.proxy( ).source.ipv4, 0xCB00'7107U );
+	BOOST_REQUIRE_EQUAL( connection.proxy( ).source_port, 40000 );
+	BOOST_REQUIRE( connection.next_request( ) );
+	BOOST_REQUIRE_EQUAL( connection.request( ).uri.path, "/c" );
+	connection.finish_request( );
+	::close( fds[1] );
+}
+
+BOOST_AUTO_TEST_CASE( daw_http_connection_test_003 ) {
+	int fds[2];
+	BOOST_REQUIRE_EQUAL( ::socketpair( AF_UNIX, SOCK_STREAM, 0, fds ), 0 );
+	daw::http::http_connection connection{fds[0], 4096};
+
+	// v2 PROXY header for a unix stream socket with one TLV
+	std::string proxy{"\r\n\r\n\0\r\nQUIT\n\x21\x31\x00\xDD", 16};
+	proxy += std::string{"/src"} + std::string( 104, '\0' ) + "/dst" + std::string( 104, '\0' );
+	proxy += std::string{"\x04\x00\x02", 3} + "ab";
+	send_all( fds[1], proxy );
+	BOOST_REQUIRE( connection.fill( ) );
+	BOOST_REQUIRE( connection.read_proxy_header( ) );
+
+	// The buffer wraps around several times, the unix paths and TLVs are kept apart from it
+	std::string const request = "GET /" + std::string( 1000, 'a' ) + " HTTP/1.1\r\nHost: x\r\n\r\n";
+	for( size_t n = 0; n < 20; ++n ) {
+		send_all( fds[1], request );
+		BOOST_REQUIRE( connection.fill( ) );
+		BOOST_REQUIRE( connection.next_request( ) );
+		connection.finish_request( );
+	}
+	BOOST_REQUIRE_EQUAL( connection.proxy( ).source_path.size( ), 108 );
+	BOOST_REQUIRE_EQUAL( connection.proxy( ).source_path.substr( 0, 5 ), daw::string_view( "/src\0", 5 ) );
+	BOOST_REQUIRE_EQUAL( connection.proxy( ).destination_path.substr( 0, 5 ), daw::string_view( "/dst\0", 5 ) );
+	BOOST_REQUIRE_EQUAL( connection.proxy( ).tlvs, daw::string_view( "\x04\x00\x02"
+	                                                                 "ab",
+	                                                                 5 ) );
+	::close( fds[1] );
+}
+
+BOOST_AUTO_TEST_CASE( daw_http_epoll_server_test_001 ) {
+	sockaddr_in addr{};
+	int const listen_fd = listen_loopback( addr );
+
+	std::vector<std::string> paths{};
+	auto server = daw::http::make_http_epoll_server( [&paths]( daw::http::http_connection &connection ) {
+		paths.push_back( connection.request( ).uri.path.to_string( ) );
+		daw::string_view const response = "HTTP/1.1 204 No Content\r\n\r\n";
+		::send( connection.fd( ), response.data( ), response.size( ), MSG_NOSIGNAL );
+	} );
+	server->add_listener( listen_fd );
+
+	int const client = ::socket( AF_INET, SOCK_STREAM, 0 );
+	BOOST_REQUIRE_EQUAL( ::connect( client, reinterpret_cast<sockaddr *>( &addr ), sizeof( addr ) ), 0 );
+	send_all( client, "GET /one HTTP/1.1\r\nHost: x\r\n\r\nGET /two HTTP/1.1\r\nHost: x\r\nConnection: close\r\n\r\n" );
+
+	for( size_t n = 0; n < 100 && paths.size( ) < 2; ++n ) {
+		server->poll( 10 );
+	}
+	BOOST_REQUIRE_EQUAL( paths.size( ), 2 );
+	BOOST_REQUIRE_EQUAL( paths[0], "/one" );
+	BOOST_REQUIRE_EQUAL( paths[1], "/two" );
+	BOOST_REQUIRE_EQUAL( server->connection_count( ), 0 );
+	BOOST_REQUIRE_EQUAL( recv_all( client ), "HTTP/1.1 204 No Content\r\n\r\nHTTP/1.1 204 No Content\r\n\r\n" );
+	::close( client );
+}
+
+BOOST_AUTO_TEST_CASE( daw_http_epoll_server_test_002 ) {
+	sockaddr_in addr{};
+	int const listen_fd = listen_loopback( addr );
+
+	std::vector<std::string> seen{};
+	auto server = daw::http::make_http_epoll_server( [&seen]( daw::http::http_connection &connection ) {
+		auto const &proxy = connection.proxy( );
+		seen.push_back( connection.request( ).uri.path.to_string( ) + " " + std::to_string( proxy.source_port ) + " " +
+		                proxy.tlvs.to_string( ) );
+		daw::string_view const response = "HTTP/1.1 204 No Content\r\n\r\n";
+		::send( connection.fd( ), response.data( ), response.size( ), MSG_NOSIGNAL );
+	} );
+	server->add_listener( listen_fd, true );
+
+	// v2 PROXY header for TCP over IPv4 with one TLV, sent in pieces ahead of two requests
+	std::string const proxy{"\r\n\r\n\0\r\nQUIT\n\x21\x11\x00\x11"
+	                        "\xCB\x00\x71\x07\x0A\x00\x00\x01\x9C\x40\x00\x50"
+	                        "\x04\x00\x02"
+	                        "ab",
+	                        33};
+	int const client = ::socket( AF_INET, SOCK_STREAM, 0 );
+	BOOST_REQUIRE_EQUAL( ::connect( client, reinterpret_cast<sockaddr *>( &addr ), sizeof( addr ) ), 0 );
+	send_all( client, proxy.substr( 0, 20 ) );
+	for( size_t n = 0; n < 100 && server->connection_count( ) == 0; ++n ) {
+		server->poll( 10 );
+	}
+	server->poll( 10 );
+	BOOST_REQUIRE_EQUAL( server->connection_count( ), 1 );
+	send_all( client, proxy.substr( 20 ) + "GET /one HTTP/1.1\r\nHost: x\r\n\r\n" );
+	for( size_t n = 0; n < 100 && seen.empty( ); ++n ) {
+		server->poll( 10 );
+	}
+	send_all( client, "GET /two HTTP/1.1\r\nHost: x\r\nConnection: close\r\n\r\n" );
+	for( size_t n = 0; n < 100 && seen.size( ) < 2; ++n ) {
+		server->poll( 10 );
+	}
+	BOOST_REQUIRE_EQUAL( seen.size( ), 2 );
+	// the PROXY header's views are still valid for the second request
+	std::string const proxied{" 40000 \x04\x00\x02"
+	                          "ab",
+	                          12};
+	BOOST_REQUIRE_EQUAL( seen[0], "/one" + proxied );
+	BOOST_REQUIRE_EQUAL( seen[1], "/two" + proxied );
+	BOOST_REQUIRE_EQUAL( recv_all( client ), "HTTP/1.1 204 No Content\r\n\r\nHTTP/1.1 204 No Content\r\n\r\n" );
+	::close( client );
+
+	// A connection that starts with a request instead of the PROXY header is closed unanswered
+	int const direct = ::socket( AF_INET, SOCK_STREAM, 0 );
+	BOOST_REQUIRE_EQUAL( ::connect( direct, reinterpret_cast<sockaddr *>( &addr ), sizeof( addr ) ), 0 );
+	send_all( direct, "GET /three HTTP/1.1\r\nHost: x\r\n\r\n" );
+	bool accepted = false;
+	for( size_t n = 0; n < 100 && ( !accepted || server->connection_count( ) != 0 ); ++n ) {
+		server->poll( 10 );
+		accepted = accepted || server->connection_count( ) != 0;
+	}
+	BOOST_REQUIRE( accepted );
+	BOOST_REQUIRE_EQUAL( server->connection_count( ), 0 );
+	BOOST_REQUIRE_EQUAL( seen.size( ), 2 );
+	BOOST_REQUIRE_EQUAL( recv_all( direct ), "" );
+	::close( direct );
+}
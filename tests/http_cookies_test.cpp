@@ -0,0 +1,63 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2017 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#define BOOST_TEST_MODULE http_cookies
+#include <daw/boost_test.h>
+
+#include "http_cookies.h"
+
+BOOST_AUTO_TEST_CASE( daw_http_cookies_test_001 ) {
+	daw::string_view const header = "session=abc123; theme=\"dark\";bad cookie; =x; lang=en-CA;empty=";
+	std::vector<std::string> names{};
+	std::vector<std::string> values{};
+	for( auto const &cookie : daw::http::make_cookie_view( header ) ) {
+		names.push_back( cookie.name.to_string( ) );
+		values.push_back( cookie.value.to_string( ) );
+	}
+	std::vector<std::string> const expected_names{"session", "theme", "lang", "empty"};
+	std::vector<std::string> const expected_values{"abc123", "dark", "en-CA", ""};
+	BOOST_REQUIRE( names == expected_names );
+	BOOST_REQUIRE( values == expected_values );
+
+	auto const empty = daw::http::make_cookie_view( "" );
+	BOOST_REQUIRE( empty.begin( ) == empty.end( ) );
+}
+
+BOOST_AUTO_TEST_CASE( daw_http_cookies_test_002 ) {
+	std::string header = "tracking=";
+	header.append( 4096, 'x' );
+	header += "; session=abc123; theme=dark; session=second";
+
+	auto const session = daw::http::find_cookie( header, "session" );
+	BOOST_REQUIRE( session );
+	BOOST_REQUIRE_EQUAL( session.value, "abc123" );
+
+	BOOST_REQUIRE_EQUAL( daw::http::find_cookie( header, "theme" ).value, "dark" );
+	BOOST_REQUIRE( !daw::http::find_cookie( header, "sess" ) );
+	BOOST_REQUIRE( !daw::http::find_cookie( header, "missing" ) );
+	BOOST_REQUIRE( !daw::http::find_cookie( header, "" ) );
+	BOOST_REQUIRE_EQUAL( daw::http::find_cookie( "a=\"quoted\"", "a" ).value, "quoted" );
+}
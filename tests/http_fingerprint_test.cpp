@@ -0,0 +1,78 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2017 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <iostream>
+#include <string>
+
+#define BOOST_TEST_MODULE http_fingerprint
+#include <daw/boost_test.h>
+
+#include "http_fingerprint.h"
+
+namespace {
+	uint64_t fingerprint( std::string const &head ) {
+		daw::http::http_request req{};
+		daw::http::http_header_index headers{};
+		uint64_t result = 0;
+		BOOST_REQUIRE_EQUAL( daw::http::parse_request_head( head, req, headers, result ), head.size( ) );
+		return result;
+	}
+} // namespace
+
+BOOST_AUTO_TEST_CASE( daw_http_fingerprint_test_001 ) {
+	auto const base = fingerprint( "GET /items?a=1&b=2 HTTP/1.1\r\nHost: example.com\r\n\r\n" );
+	// Host case and default port, parameter order and the request form do not matter
+	BOOST_REQUIRE_EQUAL( fingerprint( "GET /items?b=2&a=1 HTTP/1.1\r\nHost: Example.COM:80\r\n\r\n" ), base );
+	BOOST_REQUIRE_EQUAL( fingerprint( "GET http://EXAMPLE.com/items?b=2&&a=1 HTTP/1.1\r\n\r\n" ), base );
+	BOOST_REQUIRE_EQUAL( fingerprint( "GET http://example.com:80/items?a=1&b=2 HTTP/1.1\r\nX-A: b\r\n\r\n" ), base );
+
+	BOOST_REQUIRE_NE( fingerprint( "POST /items?a=1&b=2 HTTP/1.1\r\nHost: example.com\r\n\r\n" ), base );
+	BOOST_REQUIRE_NE( fingerprint( "GET /items?a=1&b=2 HTTP/1.1\r\nHost: example.com:8080\r\n\r\n" ), base );
+	BOOST_REQUIRE_NE( fingerprint( "GET /Items?a=1&b=2 HTTP/1.1\r\nHost: example.com\r\n\r\n" ), base );
+	BOOST_REQUIRE_NE( fingerprint( "GET /items?a=2&b=1 HTTP/1.1\r\nHost: example.com\r\n\r\n" ), base );
+	BOOST_REQUIRE_NE( fingerprint( "GET /items?a=1&b=2&a=1 HTTP/1.1\r\nHost: example.com\r\n\r\n" ), base );
+	BOOST_REQUIRE_NE( fingerprint( "GET /items?a=1&b=2 HTTP/1.1\r\nHost: example.org\r\n\r\n" ), base );
+}
+
+BOOST_AUTO_TEST_CASE( daw_http_fingerprint_test_002 ) {
+	BOOST_REQUIRE_EQUAL( fingerprint( "GET / HTTP/1.1\r\nHost: [::1]\r\n\r\n" ),
+	                     fingerprint( "GET / HTTP/1.1\r\nHost: [::1]:80\r\n\r\n" ) );
+	BOOST_REQUIRE_NE( fingerprint( "GET / HTTP/1.1\r\nHost: [::1]\r\n\r\n" ),
+	                  fingerprint( "GET / HTTP/1.1\r\nHost: [::1]:81\r\n\r\n" ) );
+	// An IPv6 Host header matches the same absolute-form target, whose host has no brackets
+	BOOST_REQUIRE_EQUAL( fingerprint( "GET http://[::1]:8080/a HTTP/1.1\r\n\r\n" ),
+	                     fingerprint( "GET /a HTTP/1.1\r\nHost: [::1]:8080\r\n\r\n" ) );
+	BOOST_REQUIRE_EQUAL( fingerprint( "GET http://[::1]/a HTTP/1.1\r\n\r\n" ),
+	                     fingerprint( "GET /a HTTP/1.1\r\nHost: [::1]:\r\n\r\n" ) );
+	// An empty port is the default port
+	BOOST_REQUIRE_EQUAL( fingerprint( "GET /a HTTP/1.1\r\nHost: example.com:\r\n\r\n" ),
+	                     fingerprint( "GET /a HTTP/1.1\r\nHost: example.com\r\n\r\n" ) );
+	BOOST_REQUIRE_EQUAL( fingerprint( "GET /a HTTP/1.1\r\nHost: example.com:\r\n\r\n" ),
+	                     fingerprint( "GET http://example.com/a HTTP/1.1\r\n\r\n" ) );
+
+	// Not set until the head is complete
+	daw::http::http_request req{};
+	daw::http::http_header_index headers{};
+	uint64_t result = 42;
+	BOOST_REQUIRE_EQUAL( daw::http::parse_request_head( "GET / HTTP/1.1\r\n", req, headers, result ), 0 );
+	BOOST_REQUIRE_EQUAL( result, 42 );
+}
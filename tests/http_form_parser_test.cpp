@@ -0,0 +1,92 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2017 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#define BOOST_TEST_MODULE http_form_parser
+#include <daw/boost_test.h>
+
+#include "http_form_parser.h"
+
+namespace {
+	std::string decode( daw::string_view const str ) {
+		std::string result( str.size( ), '\0' );
+		result.resize( daw::http::form_decode( str, &result[0] ) );
+		return result;
+	}
+
+	using field_list = std::vector<std::pair<std::string, std::string>>;
+
+	// Feed body to a parser in chunks of chunk_size
+	field_list parse_in_chunks( std::string const &body, size_t const chunk_size ) {
+		field_list result{};
+		auto on_field = [&result]( daw::http::http_form_field const &field ) {
+			result.emplace_back( decode( field.key ), decode( field.value ) );
+		};
+		daw::http::basic_http_form_parser<32> parser{};
+		for( size_t pos = 0; pos < body.size( ); pos += chunk_size ) {
+			parser.parse( daw::string_view{body}.substr( pos, chunk_size ), on_field );
+		}
+		parser.finish( on_field );
+		return result;
+	}
+} // namespace
+
+BOOST_AUTO_TEST_CASE( daw_form_decode_test_001 ) {
+	BOOST_REQUIRE_EQUAL( decode( "a+b%20c%2Bd" ), "a b c+d" );
+	BOOST_REQUIRE_EQUAL( decode( "%e2%82%ac" ), "\xE2\x82\xAC" );
+	BOOST_REQUIRE_EQUAL( decode( "" ), "" );
+	BOOST_REQUIRE_THROW( decode( "abc%2" ), daw::parser::invalid_input_exception );
+	BOOST_REQUIRE_THROW( decode( "%zz" ), daw::parser::invalid_input_exception );
+}
+
+BOOST_AUTO_TEST_CASE( daw_form_parser_test_001 ) {
+	std::string const body = "name=J%C3%BCrgen+M&empty=&flag&&city=K%C3%B6ln&q=a%26b%3Dc";
+	field_list const expected = {
+	  {"name", "J\xC3\xBCrgen M"}, {"empty", ""}, {"flag", ""}, {"city", "K\xC3\xB6ln"}, {"q", "a&b=c"}};
+	// Every chunk size splits pairs, and escapes, at a different place
+	for( size_t chunk_size = 1; chunk_size <= body.size( ); ++chunk_size ) {
+		BOOST_REQUIRE( parse_in_chunks( body, chunk_size ) == expected );
+	}
+}
+
+BOOST_AUTO_TEST_CASE( daw_form_parser_test_002 ) {
+	// Pairs within a chunk are not copied
+	std::string const body = "a=1&b=2&c";
+	daw::http::basic_http_form_parser<4> parser{};
+	std::vector<char const *> keys{};
+	auto on_field = [&keys]( daw::http::http_form_field const &field ) { keys.push_back( field.key.data( ) ); };
+	parser.parse( body, on_field );
+	BOOST_REQUIRE_EQUAL( keys.size( ), 2 );
+	BOOST_REQUIRE( keys[0] == body.data( ) );
+	BOOST_REQUIRE( keys[1] == body.data( ) + 4 );
+	parser.finish( on_field );
+	BOOST_REQUIRE_EQUAL( keys.size( ), 3 );
+
+	// A pair larger than the spill buffer that straddles chunks
+	parser.reset( );
+	parser.parse( "x=12", on_field );
+	BOOST_REQUIRE_THROW( parser.parse( "3", on_field ), daw::http::http_limit_exceeded_exception );
+}
@@ -0,0 +1,123 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2017 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <cstdint>
+#include <iostream>
+#include <string>
+
+#define BOOST_TEST_MODULE http_headers
+#include <daw/boost_test.h>
+
+#include "http_headers.h"
+
+BOOST_AUTO_TEST_CASE( daw_known_header_test_001 ) {
+	using daw::http::known_header;
+	BOOST_REQUIRE( daw::http::find_known_header( "Host" ) == known_header::host );
+	BOOST_REQUIRE( daw::http::find_known_header( "CONTENT-LENGTH" ) == known_header::content_length );
+	BOOST_REQUIRE( daw::http::find_known_header( "content-type" ) == known_header::content_type );
+	BOOST_REQUIRE( daw::http::find_known_header( "Transfer-Encoding" ) == known_header::transfer_encoding );
+	BOOST_REQUIRE( daw::http::find_known_header( "TE" ) == known_header::te );
+	BOOST_REQUIRE( daw::http::find_known_header( "X-Forwarded-Proto" ) == known_header::x_forwarded_proto );
+	BOOST_REQUIRE( daw::http::find_known_header( "X-Forwarded-Protocol" ) == known_header::unknown );
+	BOOST_REQUIRE( daw::http::find_known_header( "Content-Lengt" ) == known_header::unknown );
+	BOOST_REQUIRE( daw::http::find_known_header( "X-Custom" ) == known_header::unknown );
+	BOOST_REQUIRE( daw::http::find_known_header( "" ) == known_header::unknown );
+
+	for( size_t n = 0; n < daw::http::known_header_count; ++n ) {
+		auto const id = static_cast<known_header>( n );
+		BOOST_REQUIRE( daw::http::find_known_header( to_string( id ) ) == id );
+	}
+}
+
+BOOST_AUTO_TEST_CASE( daw_header_line_test_001 ) {
+	auto const line = daw::http::parse_header_line( "Content-Length: \t 42 \r\nHost: a\r\n" );
+	BOOST_REQUIRE_EQUAL( line.size, 23 );
+	BOOST_REQUIRE_EQUAL( line.header.name, "Content-Length" );
+	BOOST_REQUIRE_EQUAL( line.header.value, "42" );
+	BOOST_REQUIRE( line.header.id == daw::http::known_header::content_length );
+
+	BOOST_REQUIRE_EQUAL( daw::http::parse_header_line( "Content-Length: 42\r" ).size, 0 );
+	BOOST_REQUIRE_EQUAL( daw::http::parse_header_line( "Content-Len" ).size, 0 );
+	BOOST_REQUIRE_THROW( daw::http::parse_header_line( "Content-Length : 42\r\n" ),
+	                     daw::parser::invalid_input_exception );
+	BOOST_REQUIRE_THROW( daw::http::parse_header_line( ": 42\r\n" ), daw::parser::invalid_input_exception );
+	BOOST_REQUIRE_THROW( daw::http::parse_header_line( "Host: a\nX: b\r\n" ), daw::parser::invalid_input_exception );
+	BOOST_REQUIRE_THROW( daw::http::parse_header_line( "Host: a\rX: b\r\n" ), daw::parser::invalid_input_exception );
+}
+
+BOOST_AUTO_TEST_CASE( daw_header_index_test_001 ) {
+	std::string const block = "Host: www.example.com\r\n"
+	                          "Cookie: a=1\r\n"
+	                          "X-Trace-Id: 1234\r\n"
+	                          "cookie: b=2\r\n"
+	                          "\r\n"
+	                          "body";
+	daw::http::http_header_index headers{};
+	auto const size = daw::http::parse_headers( block, headers );
+	BOOST_REQUIRE_EQUAL( size, block.size( ) - 4 );
+	BOOST_REQUIRE_EQUAL( headers.size( ), 4 );
+	BOOST_REQUIRE( headers.contains( daw::http::known_header::host ) );
+	BOOST_REQUIRE( headers.contains( daw::http::known_header::cookie ) );
+	BOOST_REQUIRE( !headers.contains( daw::http::known_header::content_length ) );
+	BOOST_REQUIRE_EQUAL( headers[daw::http::known_header::host], "www.example.com" );
+	BOOST_REQUIRE_EQUAL( headers[daw::http::known_header::cookie], "a=1" );
+	BOOST_REQUIRE_EQUAL( headers[daw::http::known_header::content_length], "" );
+	BOOST_REQUIRE( headers.find( "x-trace-id" ) != headers.end( ) );
+	BOOST_REQUIRE_EQUAL( headers.find( "x-trace-id" )->value, "1234" );
+	BOOST_REQUIRE( headers.find( "X-Other" ) == headers.end( ) );
+
+	BOOST_REQUIRE_EQUAL( daw::http::parse_headers( block.substr( 0, block.size( ) - 6 ), headers ), 0 );
+}
+
+BOOST_AUTO_TEST_CASE( daw_header_index_test_002 ) {
+	daw::http::http_header_index headers{};
+	daw::http::http_limits limits{};
+	limits.max_headers = 2;
+	limits.max_header_bytes = 24;
+
+	BOOST_REQUIRE_EQUAL( daw::http::parse_headers( "A: 1\r\nB: 2\r\n\r\n", headers, limits ), 14 );
+	BOOST_REQUIRE_THROW( daw::http::parse_headers( "A: 1\r\nB: 2\r\nC: 3\r\n\r\n", headers, limits ),
+	                     daw::http::http_limit_exceeded_exception );
+	// Too long before the end of the block has arrived
+	BOOST_REQUIRE_THROW( daw::http::parse_headers( "X-Long: 01234567890123456789", headers, limits ),
+	                     daw::http::http_limit_exceeded_exception );
+	BOOST_REQUIRE_EQUAL( daw::http::parse_headers( "X-Long: 0123456789", headers, limits ), 0 );
+
+	// max_headers past the capacity of http_header_index acts as that capacity, the header after it is over the limit
+	limits = daw::http::http_limits{};
+	limits.max_headers = 1000;
+	BOOST_REQUIRE_EQUAL( daw::http::max_header_count( limits ), 64U );
+	std::string many{};
+	for( size_t n = 0; n < daw::http::http_header_index::capacity; ++n ) {
+		many += "X-" + std::to_string( n ) + ": v\r\n";
+	}
+	BOOST_REQUIRE_EQUAL( daw::http::parse_headers( many + "\r\n", headers, limits ), many.size( ) + 2 );
+	BOOST_REQUIRE_THROW( daw::http::parse_headers( many + "X-Last: v\r\n\r\n", headers, limits ),
+	                     daw::http::http_limit_exceeded_exception );
+}
+
+BOOST_AUTO_TEST_CASE( daw_header_has_token_test_001 ) {
+	BOOST_REQUIRE( daw::http::header_has_token( "keep-alive, Upgrade", "upgrade" ) );
+	BOOST_REQUIRE( daw::http::header_has_token( "Close", "close" ) );
+	BOOST_REQUIRE( !daw::http::header_has_token( "closed", "close" ) );
+	BOOST_REQUIRE( !daw::http::header_has_token( "", "close" ) );
+}
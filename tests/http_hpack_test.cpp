@@ -0,0 +1,364 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2017 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <memory>
+#include <string>
+#include <utility>
+
+#define BOOST_TEST_MODULE http_hpack
+#include <daw/boost_test.h>
+
+#include "http_cookies.h"
+#include "http_hpack.h"
+
+namespace {
+	std::string from_hex( daw::string_view const hex ) {
+		std::string result{};
+		for( size_t n = 0; n + 1 < hex.size( ); n += 2 ) {
+			result.push_back(
+			  static_cast<char>( daw::http::impl::hex_value( hex[n] ) * 16 + daw::http::impl::hex_value( hex[n + 1] ) ) );
+		}
+		return result;
+	}
+
+	std::string huffman_decode( std::string const &encoded ) {
+		std::string result( encoded.size( ) * 2, '\0' );
+		result.resize( daw::http::impl::hpack_huffman_decode( encoded, &result[0], result.size( ) ) );
+		return result;
+	}
+
+	std::string string_literal( std::string const &str ) {
+		return static_cast<char>( str.size( ) ) + str;
+	}
+
+	// Literal field with incremental indexing and a literal name, sizes under 127
+	std::string indexed_literal( std::string const &name, std::string const &value ) {
+		return '\x40' + string_literal( name ) + string_literal( value );
+	}
+
+	// Literal field without indexing and a literal name
+	std::string plain_literal( std::string const &name, std::string const &value ) {
+		return '\x00' + string_literal( name ) + string_literal( value );
+	}
+
+	std::string const get_root = from_hex( "828684" ) + plain_literal( ":authority", "a.test" );
+
+	// The decoded views can point into the block, it is kept until the next call
+	std::string last_block{};
+
+	template<typename Decoder>
+	void decode( Decoder &decoder, std::string block, daw::http::http_request &request,
+	             daw::http::http_header_index &headers ) {
+		last_block = std::move( block );
+		decoder.decode( last_block, request, headers );
+	}
+} // namespace
+
+BOOST_AUTO_TEST_CASE( daw_hpack_integer_test_001 ) {
+	// RFC 7541 C.1
+	daw::string_view str = "\x0a";
+	BOOST_REQUIRE_EQUAL( daw::http::impl::hpack_decode_integer( str, 5 ), 10U );
+	auto const encoded = from_hex( "1f9a0a" );
+	str = encoded;
+	BOOST_REQUIRE_EQUAL( daw::http::impl::hpack_decode_integer( str, 5 ), 1337U );
+	BOOST_REQUIRE( str.empty( ) );
+	str = "\x2a";
+	BOOST_REQUIRE_EQUAL( daw::http::impl::hpack_decode_integer( str, 8 ), 42U );
+
+	auto const too_large = from_hex( "1fffffffff7f" );
+	str = too_large;
+	BOOST_REQUIRE_THROW( daw::http::impl::hpack_decode_integer( str, 5 ), daw::http::hpack_compression_exception );
+	auto const truncated = from_hex( "1f9a" );
+	str = truncated;
+	BOOST_REQUIRE_THROW( daw::http::impl::hpack_decode_integer( str, 5 ), daw::http::hpack_compression_exception );
+}
+
+BOOST_AUTO_TEST_CASE( daw_hpack_huffman_test_001 ) {
+	BOOST_REQUIRE_EQUAL( huffman_decode( from_hex( "f1e3c2e5f23a6ba0ab90f4ff" ) ), "www.example.com" );
+	BOOST_REQUIRE_EQUAL( huffman_decode( from_hex( "a8eb10649cbf" ) ), "no-cache" );
+	BOOST_REQUIRE_EQUAL( huffman_decode( "" ), "" );
+
+	// Every octet, the 30bit codes included
+	auto const all_octets = huffman_decode( from_hex(
+	  "ffc7fffd8fffffe2fffffe3fffffe4fffffe5fffffe6fffffe7fffffe8ffffeafffffff3fffffa7fffffabffffffdfff"
+	  "ffebfffffecfffffedfffffeefffffefffffff0ffffff1ffffff2fffffffbfffffcffffffd3fffffd7fffffdbfffffdf"
+	  "fffffe3fffffe7fffffebfffffed4fe3f9ffaffcabf1febfafefe7fdfd2cbb00089969b71d79fb9f7fff20ffbff3ff50"
+	  "ddbd7f061c58f265cd9f469d5af66dddbf871e5f9cff7ff7fffc3ff9ffe45fff4719242cb34e6e9d68a6a3d7dac426de"
+	  "fe3cfaf7fffbfe7ffbffdffffffcfffe6ffff4bfff9ffffa3fffd3ffff53fffd5ffffb3fffeb7fffdaffffb7ffff73ff"
+	  "feeffffdeffffebffffbfffffd9ffffdbfffebffffe0ffffeeffffc3ffff8bffff1ffffe4fffee7fffb1ffff97fffd9f"
+	  "fffcdffff9fffffbffffdafffeeffff4ffffb7fffee7fffe8ffffd3fffdeffffd5fffeeffffbdffffe1fffdfffff7fff"
+	  "ff5ffffecffff07fff87fffe0ffff17fffedffff87ffff77fffeffffeaffff8bfffe3ffff93ffff87fffcbffff37ffff"
+	  "1fffff83ffffe1fffebfffe3ffff3fffff2ffffa3ffffd9fffff17ffffc7fffff27ffffdefffffbffffff2fffff8ffff"
+	  "fb7fff97fff8fffffe6fffffc1fffff87ffffe7fffffc5ffffe5fffe4ffff2fffffd1fffff4ffffffefffffe3fffffc9"
+	  "fffff97fffb3ffffcffffb7fffcdffff4ffff9ffffd1ffffcffffeaffffafffffddffffeffffff4fffff5fffffabffff"
+	  "a7ffffd7fffff9bffffecfffffb7fffff3fffffe8fffffd3fffffabfffff5fffffff7ffffecfffffdbfffffbbfffff7f"
+	  "fffff0fffffbbf" ) );
+	BOOST_REQUIRE_EQUAL( all_octets.size( ), 256U );
+	for( size_t n = 0; n < 256; ++n ) {
+		BOOST_REQUIRE_EQUAL( static_cast<uint8_t>( all_octets[n] ), n );
+	}
+}
+
+BOOST_AUTO_TEST_CASE( daw_hpack_huffman_test_002 ) {
+	// "a" is 00011 and the padding must be 1s
+	BOOST_REQUIRE_EQUAL( huffman_decode( "\x1f" ), "a" );
+	BOOST_REQUIRE_THROW( huffman_decode( "\x18" ), daw::http::hpack_compression_exception );
+	// 8 bits of padding
+	BOOST_REQUIRE_THROW( huffman_decode( "\x1f\xff" ), daw::http::hpack_compression_exception );
+	// EOS itself
+	BOOST_REQUIRE_THROW( huffman_decode( "\xff\xff\xff\xff" ), daw::http::hpack_compression_exception );
+	char out[1];
+	BOOST_REQUIRE_THROW( daw::http::impl::hpack_huffman_decode( "\x1f\x1f", out, 0 ),
+	                     daw::http::http_limit_exceeded_exception );
+}
+
+BOOST_AUTO_TEST_CASE( daw_hpack_decoder_test_001 ) {
+	// RFC 7541 C.4, three requests sharing a dynamic table
+	auto decoder = std::make_unique<daw::http::hpack_decoder>( );
+	daw::http::http_request request{};
+	daw::http::http_header_index headers{};
+
+	decode( *decoder, from_hex( "828684418cf1e3c2e5f23a6ba0ab90f4ff" ), request, headers );
+	BOOST_REQUIRE( request.method == daw::http::request_method::GET );
+	BOOST_REQUIRE_EQUAL( request.uri.scheme, "http" );
+	BOOST_REQUIRE_EQUAL( request.uri.path, "/" );
+	BOOST_REQUIRE_EQUAL( request.uri.host, "www.example.com" );
+	BOOST_REQUIRE_EQUAL( request.uri.port, 80 );
+	BOOST_REQUIRE_EQUAL( request.version.ver_major, 2 );
+	BOOST_REQUIRE_EQUAL( request.version.ver_minor, 0 );
+	BOOST_REQUIRE_EQUAL( headers.size( ), 1U );
+	BOOST_REQUIRE_EQUAL( headers[daw::http::known_header::host], "www.example.com" );
+	BOOST_REQUIRE( request.headers_present.contains( daw::http::known_header::host ) );
+	BOOST_REQUIRE_EQUAL( decoder->table_size( ), 57U );
+
+	decode( *decoder, from_hex( "828684be5886a8eb10649cbf" ), request, headers );
+	BOOST_REQUIRE_EQUAL( request.uri.host, "www.example.com" );
+	BOOST_REQUIRE_EQUAL( headers[daw::http::known_header::cache_control], "no-cache" );
+	BOOST_REQUIRE_EQUAL( headers.size( ), 2U );
+	BOOST_REQUIRE_EQUAL( decoder->table_size( ), 110U );
+
+	decode( *decoder, from_hex( "828785bf408825a849e95ba97d7f8925a849e95bb8e8b4bf" ), request, headers );
+	BOOST_REQUIRE_EQUAL( request.uri.scheme, "https" );
+	BOOST_REQUIRE_EQUAL( request.uri.path, "/index.html" );
+	BOOST_REQUIRE_EQUAL( request.uri.host, "www.example.com" );
+	BOOST_REQUIRE( !headers.contains( daw::http::known_header::cache_control ) );
+	auto const custom = headers.find( "custom-key" );
+	BOOST_REQUIRE( custom != headers.end( ) );
+	BOOST_REQUIRE_EQUAL( custom->value, "custom-value" );
+	BOOST_REQUIRE_EQUAL( decoder->table_size( ), 164U );
+	BOOST_REQUIRE_EQUAL( decoder->table_entries( ), 3U );
+}
+
+BOOST_AUTO_TEST_CASE( daw_hpack_decoder_test_002 ) {
+	// 128 octet table, entries of 32 + 16 octets so the third insert evicts and the ring wraps
+	daw::http::basic_hpack_decoder<128, 1024> decoder{};
+	daw::http::http_request request{};
+	daw::http::http_header_index headers{};
+	for( char c = 'a'; c <= 'z'; ++c ) {
+		std::string const value = std::string( 8, c ) + "-" + std::string( 3, c );
+		decode( decoder, get_root + indexed_literal( "x-name", value.substr( 0, 10 ) ), request, headers );
+		BOOST_REQUIRE_LE( decoder.table_size( ), 128U );
+		// the newest entry is index 62
+		decode( decoder, get_root + "\xbe", request, headers );
+		auto const field = headers.find( "x-name" );
+		BOOST_REQUIRE( field != headers.end( ) );
+		BOOST_REQUIRE_EQUAL( field->value, value.substr( 0, 10 ) );
+		if( c > 'a' ) {
+			auto const prev = static_cast<char>( c - 1 );
+			decode( decoder, get_root + "\xbf", request, headers );
+			BOOST_REQUIRE_EQUAL( headers.find( "x-name" )->value, std::string( 8, prev ) + "-" + prev );
+		}
+	}
+	BOOST_REQUIRE_EQUAL( decoder.table_entries( ), 2U );
+	BOOST_REQUIRE_THROW( decode( decoder, get_root + "\xc0", request, headers ),
+	                     daw::http::hpack_compression_exception );
+
+	// An entry larger than the table empties it
+	daw::http::basic_hpack_decoder<128, 1024> other{};
+	decode( other, get_root + indexed_literal( "x-a", "1" ), request, headers );
+	BOOST_REQUIRE_EQUAL( other.table_entries( ), 1U );
+	decode( other, get_root + indexed_literal( "x-b", std::string( 100, 'b' ) ), request, headers );
+	BOOST_REQUIRE_EQUAL( other.table_entries( ), 0U );
+	BOOST_REQUIRE_EQUAL( other.table_size( ), 0U );
+	BOOST_REQUIRE_EQUAL( headers.find( "x-b" )->value.size( ), 100U );
+}
+
+BOOST_AUTO_TEST_CASE( daw_hpack_decoder_test_003 ) {
+	// Dynamic table size updates
+	auto decoder = std::make_unique<daw::http::hpack_decoder>( );
+	daw::http::http_request request{};
+	daw::http::http_header_index headers{};
+	decode( *decoder, get_root + indexed_literal( "x-a", "1" ), request, headers );
+	BOOST_REQUIRE_EQUAL( decoder->table_entries( ), 1U );
+
+	// only at the start of a block, and not above the limit
+	BOOST_REQUIRE_THROW( decode( *decoder, get_root + "\x20", request, headers ),
+	                     daw::http::hpack_compression_exception );
+	decoder = std::make_unique<daw::http::hpack_decoder>( );
+	BOOST_REQUIRE_THROW( decode( *decoder, from_hex( "3fe21f" ) + get_root, request, headers ),
+	                     daw::http::hpack_compression_exception );
+
+	decoder = std::make_unique<daw::http::hpack_decoder>( );
+	decode( *decoder, get_root + indexed_literal( "x-a", "1" ), request, headers );
+	decode( *decoder, "\x20\x3f\x11" + get_root, request, headers );
+	BOOST_REQUIRE_EQUAL( decoder->table_entries( ), 0U );
+	BOOST_REQUIRE_EQUAL( decoder->max_table_size( ), 48U );
+
+	// After a smaller limit is acknowledged the next block has to start with an update
+	decoder->set_table_size_limit( 32 );
+	BOOST_REQUIRE_THROW( decode( *decoder, get_root, request, headers ), daw::http::hpack_compression_exception );
+	decoder = std::make_unique<daw::http::hpack_decoder>( );
+	decoder->set_table_size_limit( 32 );
+	decode( *decoder, "\x3f\x01" + get_root, request, headers );
+	BOOST_REQUIRE_EQUAL( decoder->max_table_size( ), 32U );
+	BOOST_REQUIRE_THROW( decoder->set_table_size_limit( 8192 ), daw::http::http_limit_exceeded_exception );
+}
+
+BOOST_AUTO_TEST_CASE( daw_hpack_decoder_test_004 ) {
+	// Malformed requests are rejected after the block, the table stays in step with the encoder
+	auto decoder = std::make_unique<daw::http::hpack_decoder>( );
+	daw::http::http_request request{};
+	daw::http::http_header_index headers{};
+	auto const expect_malformed = [&]( std::string const &block ) {
+		bool rejected = false;
+		try {
+			decode( *decoder, block, request, headers );
+		} catch( daw::http::hpack_compression_exception const & ) {
+			BOOST_FAIL( "Not a compression error" );
+		} catch( daw::parser::invalid_input_exception const & ) { rejected = true; }
+		BOOST_REQUIRE_MESSAGE( rejected, block );
+	};
+	expect_malformed( indexed_literal( "x-a", "1" ) + get_root );
+	expect_malformed( get_root + indexed_literal( "X-Upper", "1" ) );
+	expect_malformed( get_root + plain_literal( "connection", "close" ) );
+	expect_malformed( get_root + plain_literal( "te", "gzip" ) );
+	expect_malformed( get_root + from_hex( "82" ) );
+	expect_malformed( get_root + plain_literal( ":status", "200" ) );
+	expect_malformed( from_hex( "8684" ) + plain_literal( ":authority", "a.test" ) );
+	expect_malformed( from_hex( "8286" ) + plain_literal( ":path", "a" ) );
+	expect_malformed( from_hex( "828684" ) + plain_literal( ":authority", "user@a.test" ) );
+	// every indexed_literal above was still added
+	BOOST_REQUIRE_EQUAL( decoder->table_entries( ), 2U );
+
+	decode( *decoder, get_root + "\xbf" + plain_literal( "te", "trailers" ), request, headers );
+	BOOST_REQUIRE_EQUAL( headers.size( ), 3U );
+	BOOST_REQUIRE_EQUAL( headers.find( "x-a" )->value, "1" );
+
+	BOOST_REQUIRE_THROW( decode( *decoder, "\x80", request, headers ), daw::http::hpack_compression_exception );
+	decoder = std::make_unique<daw::http::hpack_decoder>( );
+	BOOST_REQUIRE_THROW( decode( *decoder, get_root + "\x40\x05x-a", request, headers ),
+	                     daw::http::hpack_compression_exception );
+}
+
+BOOST_AUTO_TEST_CASE( daw_hpack_decoder_test_005 ) {
+	auto decoder = std::make_unique<daw::http::hpack_decoder>( );
+	daw::http::http_request request{};
+	daw::http::http_header_index headers{};
+
+	decode( *decoder, plain_literal( ":method", "CONNECT" ) + plain_literal( ":authority", "[::1]:8443" ), request,
+	        headers );
+	BOOST_REQUIRE( request.method == daw::http::request_method::CONNECT );
+	BOOST_REQUIRE( request.uri.address.type == daw::http::host_type::ipv6 );
+	BOOST_REQUIRE_EQUAL( request.uri.port, 8443 );
+	BOOST_REQUIRE_THROW( decode( *decoder, plain_literal( ":method", "CONNECT" ) + from_hex( "8684" ) +
+	                                         plain_literal( ":authority", "a.test" ),
+	                             request, headers ),
+	                     daw::parser::invalid_input_exception );
+
+	decode( *decoder, plain_literal( ":method", "OPTIONS" ) + from_hex( "86" ) + plain_literal( ":path", "*" ), request,
+	        headers );
+	BOOST_REQUIRE( request.method == daw::http::request_method::OPTIONS );
+	BOOST_REQUIRE_EQUAL( request.uri.path, "*" );
+	BOOST_REQUIRE( headers.empty( ) );
+
+	decode( *decoder,
+	        from_hex( "8286" ) + plain_literal( ":path", "/search?q=1#top" ) + plain_literal( ":authority", "10.0.0.1:81" ) +
+	          plain_literal( "host", "other" ),
+	        request, headers );
+	BOOST_REQUIRE_EQUAL( request.uri.path, "/search" );
+	BOOST_REQUIRE_EQUAL( request.uri.query, "q=1" );
+	BOOST_REQUIRE_EQUAL( request.uri.address.ipv4, 0x0A00'0001U );
+	BOOST_REQUIRE_EQUAL( request.uri.port, 81 );
+	// an explicit Host is kept as sent
+	BOOST_REQUIRE_EQUAL( headers.size( ), 1U );
+	BOOST_REQUIRE_EQUAL( headers[daw::http::known_header::host], "other" );
+}
+
+BOOST_AUTO_TEST_CASE( daw_hpack_decoder_test_006 ) {
+	daw::http::http_limits limits{};
+	limits.max_headers = 2;
+	auto decoder = std::make_unique<daw::http::hpack_decoder>( limits );
+	daw::http::http_request request{};
+	daw::http::http_header_index headers{};
+	decode( *decoder, get_root + plain_literal( "x-a", "1" ), request, headers );
+	BOOST_REQUIRE_EQUAL( headers.size( ), 2U );
+	BOOST_REQUIRE_THROW(
+	  decode( *decoder, get_root + plain_literal( "x-a", "1" ) + indexed_literal( "x-b", "2" ), request, headers ),
+	  daw::http::http_limit_exceeded_exception );
+	BOOST_REQUIRE_EQUAL( decoder->table_entries( ), 1U );
+
+	// Huffman output that does not fit the scratch buffer
+	daw::http::basic_hpack_decoder<4096, 8> small{};
+	BOOST_REQUIRE_THROW( decode( small, get_root + std::string( "\x00\x03x-a\x8c", 6 ) + from_hex( "f1e3c2e5f23a6ba0ab90f4ff" ), request,
+	                             headers ),
+	                     daw::http::http_limit_exceeded_exception );
+}
+
+BOOST_AUTO_TEST_CASE( daw_hpack_decoder_test_007 ) {
+	// Cookie fields are joined into one header as in HTTP/1.1, RFC 9113 8.2.3
+	auto decoder = std::make_unique<daw::http::hpack_decoder>( );
+	daw::http::http_request request{};
+	daw::http::http_header_index headers{};
+	decode( *decoder,
+	        get_root + plain_literal( "cookie", "a=1" ) + plain_literal( "x-a", "1" ) +
+	          indexed_literal( "cookie", "b=2" ) + plain_literal( "cookie", "c=3" ),
+	        request, headers );
+	BOOST_REQUIRE_EQUAL( headers.size( ), 3U );
+	BOOST_REQUIRE_EQUAL( headers[daw::http::known_header::cookie], "a=1; b=2; c=3" );
+	BOOST_REQUIRE( request.headers_present.contains( daw::http::known_header::cookie ) );
+	size_t count = 0;
+	for( auto const &cookie : daw::http::make_cookie_view( headers[daw::http::known_header::cookie] ) ) {
+		BOOST_REQUIRE_EQUAL( cookie.value.size( ), 1U );
+		++count;
+	}
+	BOOST_REQUIRE_EQUAL( count, 3U );
+
+	// A single field is left where it is in the block
+	decode( *decoder, get_root + plain_literal( "cookie", "a=1" ), request, headers );
+	BOOST_REQUIRE_EQUAL( headers[daw::http::known_header::cookie], "a=1" );
+	BOOST_REQUIRE( headers[daw::http::known_header::cookie].data( ) > last_block.data( ) );
+
+	// All the cookie fields take one header of the limit
+	daw::http::http_limits limits{};
+	limits.max_headers = 2;
+	auto limited = std::make_unique<daw::http::hpack_decoder>( limits );
+	decode( *limited,
+	        get_root + plain_literal( "cookie", "a=1" ) + plain_literal( "cookie", "b=2" ) +
+	          plain_literal( "cookie", "c=3" ),
+	        request, headers );
+	BOOST_REQUIRE_EQUAL( headers.size( ), 2U );
+	BOOST_REQUIRE_THROW( decode( *limited,
+	                             get_root + plain_literal( "cookie", "a=1" ) + plain_literal( "x-a", "1" ) +
+	                               plain_literal( "x-b", "2" ),
+	                             request, headers ),
+	                     daw::http::http_limit_exceeded_exception );
+}
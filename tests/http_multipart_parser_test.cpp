@@ -0,0 +1,117 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2017 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#define BOOST_TEST_MODULE http_multipart_parser
+#include <daw/boost_test.h>
+
+#include "http_multipart_parser.h"
+
+namespace {
+	struct part {
+		std::string disposition;
+		std::string data;
+		size_t data_calls = 0;
+		bool ended = false;
+	};
+
+	struct recording_handler {
+		std::vector<part> parts{};
+		char const *first = nullptr;
+		char const *last = nullptr;
+
+		void part_begin( daw::http::http_header_index const &headers ) {
+			parts.emplace_back( );
+			parts.back( ).disposition = headers.find( "content-disposition" )->value.to_string( );
+		}
+
+		void part_data( daw::string_view const str ) {
+			parts.back( ).data.append( str.data( ), str.size( ) );
+			++parts.back( ).data_calls;
+			if( first != nullptr ) {
+				BOOST_REQUIRE( first <= str.data( ) && str.data( ) + str.size( ) <= last );
+			}
+		}
+
+		void part_end( ) {
+			parts.back( ).ended = true;
+		}
+	};
+
+	std::string const body = "preamble\r\n"
+	                         "--XyZ\r\n"
+	                         "Content-Disposition: form-data; name=\"a\"\r\n"
+	                         "\r\n"
+	                         "first\r\n--Xy not a boundary\r\n"
+	                         "--XyZ \r\n"
+	                         "Content-Disposition: form-data; name=\"b\"; filename=\"b.txt\"\r\n"
+	                         "Content-Type: text/plain\r\n"
+	                         "\r\n"
+	                         "\r\r\n\r\n-\r\n--XyY\r\n"
+	                         "--XyZ--\r\n"
+	                         "epilogue";
+} // namespace
+
+BOOST_AUTO_TEST_CASE( daw_multipart_boundary_test_001 ) {
+	BOOST_REQUIRE_EQUAL( daw::http::find_multipart_boundary( "multipart/form-data; boundary=XyZ" ), "XyZ" );
+	BOOST_REQUIRE_EQUAL( daw::http::find_multipart_boundary( "multipart/mixed;charset=x; Boundary=\"a b\"; x=1" ),
+	                     "a b" );
+	BOOST_REQUIRE_EQUAL( daw::http::find_multipart_boundary( "multipart/form-data" ), "" );
+	BOOST_REQUIRE_THROW( daw::http::basic_http_multipart_parser<recording_handler>( "", recording_handler{} ),
+	                     daw::parser::invalid_input_exception );
+}
+
+BOOST_AUTO_TEST_CASE( daw_multipart_parser_test_001 ) {
+	// Every chunk size splits the delimiters and headers at a different place
+	for( size_t chunk_size = 1; chunk_size <= body.size( ); ++chunk_size ) {
+		auto parser = daw::http::make_http_multipart_parser( "XyZ", recording_handler{} );
+		for( size_t pos = 0; pos < body.size( ); pos += chunk_size ) {
+			parser->parse( daw::string_view{body}.substr( pos, chunk_size ) );
+		}
+		BOOST_REQUIRE( parser->done( ) );
+		auto const &parts = parser->handler( ).parts;
+		BOOST_REQUIRE_EQUAL( parts.size( ), 2 );
+		BOOST_REQUIRE_EQUAL( parts[0].disposition, "form-data; name=\"a\"" );
+		BOOST_REQUIRE_EQUAL( parts[0].data, "first\r\n--Xy not a boundary" );
+		BOOST_REQUIRE( parts[0].ended );
+		BOOST_REQUIRE_EQUAL( parts[1].disposition, "form-data; name=\"b\"; filename=\"b.txt\"" );
+		BOOST_REQUIRE_EQUAL( parts[1].data, "\r\r\n\r\n-\r\n--XyY" );
+		BOOST_REQUIRE( parts[1].ended );
+	}
+}
+
+BOOST_AUTO_TEST_CASE( daw_multipart_parser_test_002 ) {
+	// Data within one chunk is passed on without copying
+	recording_handler handler{};
+	handler.first = body.data( );
+	handler.last = body.data( ) + body.size( );
+	auto parser = daw::http::make_http_multipart_parser( "XyZ", std::move( handler ) );
+	parser->parse( body );
+	BOOST_REQUIRE( parser->done( ) );
+	BOOST_REQUIRE_EQUAL( parser->handler( ).parts[0].data_calls, 1 );
+
+	auto bad = daw::http::make_http_multipart_parser( "XyZ", recording_handler{} );
+	BOOST_REQUIRE_THROW( bad->parse( "--XyZx\r\n" ), daw::parser::invalid_input_exception );
+}
@@ -0,0 +1,68 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2017 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <cstdint>
+#include <memory>
+
+#define BOOST_TEST_MODULE http_parser_context
+#include <daw/boost_test.h>
+
+#include "http_parser_context.h"
+
+static_assert( alignof( daw::http::http_parser_context ) == daw::http::cache_line_size, "" );
+static_assert( sizeof( daw::http::http_parser_context ) % daw::http::cache_line_size == 0, "" );
+static_assert( daw::http::to_string_view( daw::http::request_method::DELETE ) == "DELETE", "" );
+
+BOOST_AUTO_TEST_CASE( daw_http_parser_context_test_001 ) {
+	daw::http::http_parser_context context{};
+	BOOST_REQUIRE_EQUAL( reinterpret_cast<uintptr_t>( &context ) % daw::http::cache_line_size, 0U );
+
+	daw::string_view const req = "GET /caf%C3%A9/a%20b HTTP/1.1\r\nHost: a.test\r\n\r\n";
+	BOOST_REQUIRE_EQUAL( context.parse( req.substr( 0, 20 ) ), 0U );
+	BOOST_REQUIRE_EQUAL( context.parse( req ), req.size( ) );
+	BOOST_REQUIRE_EQUAL( context.headers[daw::http::known_header::host], "a.test" );
+	BOOST_REQUIRE_EQUAL( context.decoded_path( ), "/caf\xC3\xA9/a b" );
+	BOOST_REQUIRE_EQUAL( context.counters.requests, 1U );
+	BOOST_REQUIRE_EQUAL( context.counters.bytes, req.size( ) );
+
+	BOOST_REQUIRE_THROW( context.parse( "GET / HTTP/1.1\r\nBad Header: x\r\n\r\n" ),
+	                     daw::parser::invalid_input_exception );
+	BOOST_REQUIRE_EQUAL( context.counters.invalid, 1U );
+	BOOST_REQUIRE_EQUAL( context.counters.over_limit, 0U );
+}
+
+BOOST_AUTO_TEST_CASE( daw_http_parser_context_test_002 ) {
+	daw::http::http_limits limits{};
+	limits.max_headers = 1;
+	daw::http::basic_http_parser_context<16> context{limits};
+	BOOST_REQUIRE_THROW( context.parse( "GET / HTTP/1.1\r\nHost: a\r\nAccept: b\r\n\r\n" ),
+	                     daw::http::http_limit_exceeded_exception );
+	BOOST_REQUIRE_EQUAL( context.counters.over_limit, 1U );
+	BOOST_REQUIRE_EQUAL( context.counters.invalid, 0U );
+
+	context.parse( "GET /%FF HTTP/1.1\r\n\r\n" );
+	BOOST_REQUIRE_THROW( context.decoded_path( ), daw::parser::invalid_input_exception );
+	context.parse( "GET /0123456789abcdef HTTP/1.1\r\n\r\n" );
+	BOOST_REQUIRE_THROW( context.decoded_path( ), daw::http::http_limit_exceeded_exception );
+	BOOST_REQUIRE_EQUAL( context.counters.requests, 2U );
+	BOOST_REQUIRE_EQUAL( daw::http::to_string( daw::http::request_method::OPTIONS ), "OPTIONS" );
+}
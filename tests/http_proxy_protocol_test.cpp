@@ -0,0 +1,182 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2017 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <string>
+
+#define BOOST_TEST_MODULE http_proxy_protocol
+#include <daw/boost_test.h>
+
+#include "http_proxy_protocol.h"
+
+namespace {
+	std::string const v2_signature( "\r\n\r\n\0\r\nQUIT\n", 12 );
+
+	std::string v2_header( char const version_command, char const family_transport, std::string const &block ) {
+		return v2_signature + version_command + family_transport + static_cast<char>( block.size( ) >> 8 ) +
+		       static_cast<char>( block.size( ) & 0xFF ) + block;
+	}
+
+	std::string const request = "GET / HTTP/1.1\r\nHost: a.test\r\n\r\n";
+
+	static_assert( daw::http::detect_proxy_protocol( "PROXY TCP4 " ) == daw::http::proxy_protocol_prefix::v1,
+	               "v1 detection should be constexpr" );
+} // namespace
+
+BOOST_AUTO_TEST_CASE( daw_proxy_protocol_detect_test_001 ) {
+	using daw::http::proxy_protocol_prefix;
+	BOOST_REQUIRE( daw::http::detect_proxy_protocol( request ) == proxy_protocol_prefix::none );
+	BOOST_REQUIRE( daw::http::detect_proxy_protocol( "PROXY TCP4" ) == proxy_protocol_prefix::v1 );
+	BOOST_REQUIRE( daw::http::detect_proxy_protocol( "PROX" ) == proxy_protocol_prefix::incomplete );
+	BOOST_REQUIRE( daw::http::detect_proxy_protocol( "PROXZ" ) == proxy_protocol_prefix::none );
+	BOOST_REQUIRE( daw::http::detect_proxy_protocol( "" ) == proxy_protocol_prefix::incomplete );
+	BOOST_REQUIRE( daw::http::detect_proxy_protocol( v2_signature ) == proxy_protocol_prefix::v2 );
+	for( size_t n = 1; n < 12; ++n ) {
+		BOOST_REQUIRE( daw::http::detect_proxy_protocol( v2_signature.substr( 0, n ) ) ==
+		               proxy_protocol_prefix::incomplete );
+	}
+	auto bad = v2_signature;
+	bad[10] = 'X';
+	BOOST_REQUIRE( daw::http::detect_proxy_protocol( bad ) == proxy_protocol_prefix::none );
+	BOOST_REQUIRE( daw::http::detect_proxy_protocol( "\r\n\r\n" + request ) == proxy_protocol_prefix::none );
+}
+
+BOOST_AUTO_TEST_CASE( daw_proxy_protocol_v1_test_001 ) {
+	std::string const v4 = "PROXY TCP4 192.168.0.1 10.0.0.2 56324 443\r\n";
+	auto const data = v4 + request;
+	daw::http::proxy_header header{};
+	BOOST_REQUIRE_EQUAL( daw::http::parse_proxy_header( daw::string_view{data}.substr( 0, 20 ), header ), 0U );
+	auto const offset = daw::http::parse_proxy_header( data, header );
+	BOOST_REQUIRE_EQUAL( offset, v4.size( ) );
+	BOOST_REQUIRE( daw::string_view{data}.substr( offset ) == request );
+	BOOST_REQUIRE_EQUAL( header.version, 1 );
+	BOOST_REQUIRE( !header.local );
+	BOOST_REQUIRE( header.family == daw::http::proxy_address_family::inet );
+	BOOST_REQUIRE( header.transport == daw::http::proxy_transport::stream );
+	BOOST_REQUIRE_EQUAL( header.source.ipv4, 0xC0A8'0001U );
+	BOOST_REQUIRE_EQUAL( header.destination.ipv4, 0x0A00'0002U );
+	BOOST_REQUIRE_EQUAL( header.source_port, 56324 );
+	BOOST_REQUIRE_EQUAL( header.destination_port, 443 );
+
+	std::string const v6 = "PROXY TCP6 2001:db8::1 ::1 1 65535\r\n";
+	BOOST_REQUIRE_EQUAL( daw::http::parse_proxy_header( v6 + request, header ), v6.size( ) );
+	BOOST_REQUIRE( header.family == daw::http::proxy_address_family::inet6 );
+	BOOST_REQUIRE_EQUAL( header.source.ipv6.octets[0], 0x20 );
+	BOOST_REQUIRE_EQUAL( header.source.ipv6.octets[15], 1 );
+	BOOST_REQUIRE_EQUAL( header.destination.ipv6.octets[15], 1 );
+	BOOST_REQUIRE_EQUAL( header.destination_port, 65535 );
+
+	std::string const unknown = "PROXY UNKNOWN ffff:f...f:ffff ffff:f...f:ffff 65535 65535\r\n";
+	BOOST_REQUIRE_EQUAL( daw::http::parse_proxy_header( unknown, header ), unknown.size( ) );
+	BOOST_REQUIRE( header.local );
+	BOOST_REQUIRE( header.family == daw::http::proxy_address_family::unspecified );
+}
+
+BOOST_AUTO_TEST_CASE( daw_proxy_protocol_v1_test_002 ) {
+	daw::http::proxy_header header{};
+	for( daw::string_view const bad :
+	     {"PROXY TCP5 1.2.3.4 1.2.3.4 1 2\r\n", "PROXY TCP4 1.2.3.4 1.2.3.4 1\r\n", "PROXY TCP4 1.2.3.4  1.2.3.4 1 2\r\n",
+	      "PROXY TCP4 1.2.3.4 1.2.3.4 1 2 3\r\n", "PROXY TCP4 ::1 1.2.3.4 1 2\r\n", "PROXY TCP6 1.2.3.4 ::1 1 2\r\n",
+	      "PROXY TCP4 1.2.3.4 1.2.3.4 1 65536\r\n", "PROXY TCP4 1.2.3.400 1.2.3.4 1 2\r\n", "GET / HTTP/1.1\r\n"} ) {
+		BOOST_REQUIRE_THROW( daw::http::parse_proxy_header( bad, header ), daw::parser::parser_exception );
+	}
+	// No CRLF within the 107 octets a v1 header can have
+	BOOST_REQUIRE_THROW( daw::http::parse_proxy_header( "PROXY UNKNOWN " + std::string( 100, 'x' ), header ),
+	                     daw::parser::invalid_input_exception );
+}
+
+BOOST_AUTO_TEST_CASE( daw_proxy_protocol_v2_test_001 ) {
+	daw::http::proxy_header header{};
+	// PROXY over TCP4 with one TLV
+	std::string const block_v4( "\xC0\xA8\x00\x01\x0A\x00\x00\x02\xDC\x04\x01\xBB"
+	                            "\x04\x00\x01\x07",
+	                            16 );
+	auto const v4 = v2_header( '\x21', '\x11', block_v4 );
+	auto const data = v4 + request;
+	for( size_t n = 0; n < v4.size( ); ++n ) {
+		BOOST_REQUIRE_EQUAL( daw::http::parse_proxy_header( daw::string_view{data}.substr( 0, n ), header ), 0U );
+	}
+	auto const offset = daw::http::parse_proxy_header( data, header );
+	BOOST_REQUIRE_EQUAL( offset, v4.size( ) );
+	BOOST_REQUIRE_EQUAL( header.version, 2 );
+	BOOST_REQUIRE( !header.local );
+	BOOST_REQUIRE( header.family == daw::http::proxy_address_family::inet );
+	BOOST_REQUIRE( header.transport == daw::http::proxy_transport::stream );
+	BOOST_REQUIRE_EQUAL( header.source.ipv4, 0xC0A8'0001U );
+	BOOST_REQUIRE_EQUAL( header.destination.ipv4, 0x0A00'0002U );
+	BOOST_REQUIRE_EQUAL( header.source_port, 56324 );
+	BOOST_REQUIRE_EQUAL( header.destination_port, 443 );
+	BOOST_REQUIRE_EQUAL( header.tlvs.size( ), 4U );
+	BOOST_REQUIRE_EQUAL( header.tlvs.data( ), data.data( ) + 28 );
+
+	// UDP6
+	std::string block_v6( 36, '\0' );
+	block_v6[15] = 1;
+	block_v6[16] = '\xFE';
+	block_v6[17] = '\x80';
+	block_v6[33] = 80;
+	block_v6[35] = 81;
+	BOOST_REQUIRE_EQUAL( daw::http::parse_proxy_header( v2_header( '\x21', '\x22', block_v6 ), header ), 52U );
+	BOOST_REQUIRE( header.family == daw::http::proxy_address_family::inet6 );
+	BOOST_REQUIRE( header.transport == daw::http::proxy_transport::datagram );
+	BOOST_REQUIRE_EQUAL( header.source.ipv6.octets[15], 1 );
+	BOOST_REQUIRE_EQUAL( header.destination.ipv6.octets[0], 0xFE );
+	BOOST_REQUIRE_EQUAL( header.source_port, 80 );
+	BOOST_REQUIRE_EQUAL( header.destination_port, 81 );
+	BOOST_REQUIRE( header.tlvs.empty( ) );
+
+	// unix stream
+	std::string block_unix( 216, '\0' );
+	block_unix.replace( 0, 9, "/run/a.sk" );
+	auto const unix_data = v2_header( '\x21', '\x31', block_unix );
+	BOOST_REQUIRE_EQUAL( daw::http::parse_proxy_header( unix_data, header ), 232U );
+	BOOST_REQUIRE( header.family == daw::http::proxy_address_family::unix_socket );
+	BOOST_REQUIRE_EQUAL( header.source_path.size( ), 108U );
+	BOOST_REQUIRE_EQUAL( header.source_path.substr( 0, 9 ), "/run/a.sk" );
+
+	// LOCAL, e.g. a health check from the balancer, addresses are ignored
+	BOOST_REQUIRE_EQUAL( daw::http::parse_proxy_header( v2_header( '\x20', '\x11', block_v4 ), header ), 32U );
+	BOOST_REQUIRE( header.local );
+	BOOST_REQUIRE( header.family == daw::http::proxy_address_family::unspecified );
+	BOOST_REQUIRE_EQUAL( header.source_port, 0 );
+	BOOST_REQUIRE_EQUAL( daw::http::parse_proxy_header( v2_header( '\x20', '\x00', "" ), header ), 16U );
+}
+
+BOOST_AUTO_TEST_CASE( daw_proxy_protocol_v2_test_002 ) {
+	daw::http::proxy_header header{};
+	std::string const block_v4( 12, '\x01' );
+	// version 1 and 3, command 2
+	BOOST_REQUIRE_THROW( daw::http::parse_proxy_header( v2_header( '\x11', '\x11', block_v4 ), header ),
+	                     daw::parser::invalid_input_exception );
+	BOOST_REQUIRE_THROW( daw::http::parse_proxy_header( v2_header( '\x31', '\x11', block_v4 ), header ),
+	                     daw::parser::invalid_input_exception );
+	BOOST_REQUIRE_THROW( daw::http::parse_proxy_header( v2_header( '\x22', '\x11', block_v4 ), header ),
+	                     daw::parser::invalid_input_exception );
+	// unknown family or transport, address block too small
+	BOOST_REQUIRE_THROW( daw::http::parse_proxy_header( v2_header( '\x21', '\x41', block_v4 ), header ),
+	                     daw::parser::invalid_input_exception );
+	BOOST_REQUIRE_THROW( daw::http::parse_proxy_header( v2_header( '\x21', '\x13', block_v4 ), header ),
+	                     daw::parser::invalid_input_exception );
+	BOOST_REQUIRE_THROW( daw::http::parse_proxy_header( v2_header( '\x21', '\x21', block_v4 ), header ),
+	                     daw::parser::invalid_input_exception );
+	BOOST_REQUIRE_THROW( daw::http::parse_proxy_header( v2_header( '\x21', '\x11', block_v4.substr( 0, 11 ) ), header ),
+	                     daw::parser::invalid_input_exception );
+}
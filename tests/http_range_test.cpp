@@ -0,0 +1,98 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2017 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <string>
+
+#define BOOST_TEST_MODULE http_range
+#include <daw/boost_test.h>
+
+#include "http_range.h"
+
+namespace {
+	std::string to_text( daw::http::http_byte_ranges const &ranges ) {
+		std::string result{};
+		for( auto const &range : ranges ) {
+			if( !result.empty( ) ) {
+				result += ',';
+			}
+			result += std::to_string( range.first ) + "-" + std::to_string( range.last );
+		}
+		return result;
+	}
+
+	std::string parse( daw::string_view const value, uint64_t const length ) {
+		return to_text( daw::http::parse_byte_ranges( value, length ) );
+	}
+} // namespace
+
+static_assert( daw::http::parse_byte_ranges( "bytes=0-99", 1000 ).total_size( ) == 100, "" );
+static_assert( daw::http::parse_byte_ranges( "bytes=-500", 10000 )[0].first == 9500, "" );
+
+BOOST_AUTO_TEST_CASE( daw_http_range_test_001 ) {
+	// RFC 9110 14.1.2 examples against a 10000 octet resource
+	BOOST_REQUIRE_EQUAL( parse( "bytes=0-499", 10000 ), "0-499" );
+	BOOST_REQUIRE_EQUAL( parse( "bytes=500-999", 10000 ), "500-999" );
+	BOOST_REQUIRE_EQUAL( parse( "bytes=-500", 10000 ), "9500-9999" );
+	BOOST_REQUIRE_EQUAL( parse( "bytes=9500-", 10000 ), "9500-9999" );
+	BOOST_REQUIRE_EQUAL( parse( "bytes=0-0,-1", 10000 ), "0-0,9999-9999" );
+	BOOST_REQUIRE_EQUAL( parse( "bytes=0-999,4500-5499,-1000", 10000 ), "0-999,4500-5499,9000-9999" );
+	BOOST_REQUIRE_EQUAL( parse( "bytes=500-600,601-999", 10000 ), "500-999" );
+	BOOST_REQUIRE_EQUAL( parse( "bytes=500-700,601-999", 10000 ), "500-999" );
+	BOOST_REQUIRE_EQUAL( parse( "BYTES=1-2", 10 ), "1-2" );
+}
+
+BOOST_AUTO_TEST_CASE( daw_http_range_test_002 ) {
+	// clamped to the resource, unsatisfiable ranges are dropped
+	BOOST_REQUIRE_EQUAL( parse( "bytes=0-99999999999999999999999", 100 ), "0-99" );
+	BOOST_REQUIRE_EQUAL( parse( "bytes=-99999999999999999999999", 100 ), "0-99" );
+	// leading zeros are not significant digits
+	BOOST_REQUIRE_EQUAL( parse( "bytes=00000000000000000005-", 100 ), "5-99" );
+	BOOST_REQUIRE_EQUAL( parse( "bytes=0000000000000000000000-000000000000000000000009", 100 ), "0-9" );
+	BOOST_REQUIRE_EQUAL( parse( "bytes=-00000000000000000000010", 100 ), "90-99" );
+	BOOST_REQUIRE_EQUAL( parse( "bytes=00000000000000000000100-", 100 ), "" );
+	BOOST_REQUIRE_EQUAL( parse( "bytes=50-, 100-200, -0", 100 ), "50-99" );
+	BOOST_REQUIRE_EQUAL( parse( "bytes=100-200", 100 ), "" );
+	BOOST_REQUIRE_EQUAL( parse( "bytes=-10", 0 ), "" );
+	BOOST_REQUIRE_EQUAL( parse( "  bytes=  , 7-8 ,, 1-3 ,  ", 100 ), "1-3,7-8" );
+	BOOST_REQUIRE_EQUAL( parse( "bytes=10-20,0-5,6-9,30-40,25-35", 100 ), "0-20,25-40" );
+}
+
+BOOST_AUTO_TEST_CASE( daw_http_range_test_003 ) {
+	for( daw::string_view const bad : {"", "bytes", "bytes=", "bytes= ,", "items=0-1", "bytes=1", "bytes=5-4",
+	                                   "bytes=a-b", "bytes=1 -2", "bytes=--1", "bytes=1-2-3", "bytes=0x10-20",
+	                                   "bytes = 1-2"} ) {
+		BOOST_REQUIRE_THROW( daw::http::parse_byte_ranges( bad, 100 ), daw::parser::invalid_input_exception );
+	}
+	// The element count is checked first, a bad element past the limit does not matter
+	std::string many = "bytes=0-0";
+	for( size_t n = 1; n < daw::http::http_byte_ranges::capacity; ++n ) {
+		many += "," + std::to_string( n ) + "-" + std::to_string( n );
+	}
+	BOOST_REQUIRE_EQUAL( parse( many, 100 ), "0-15" );
+	BOOST_REQUIRE_THROW( daw::http::parse_byte_ranges( many + ",x", 100 ), daw::http::http_limit_exceeded_exception );
+	BOOST_REQUIRE_EQUAL( daw::http::parse_byte_ranges<2>( "bytes=0-1,5-6", 100 ).size( ), 2U );
+	// empty list elements do not count against the limit
+	BOOST_REQUIRE_EQUAL( daw::http::parse_byte_ranges<1>( "bytes=0-1,", 100 ).size( ), 1U );
+	BOOST_REQUIRE_EQUAL( daw::http::parse_byte_ranges<2>( "bytes=0-1, ,5-6,,", 100 ).size( ), 2U );
+	BOOST_REQUIRE_THROW( daw::http::parse_byte_ranges<2>( "bytes=0-1,,5-6,7-8", 100 ),
+	                     daw::http::http_limit_exceeded_exception );
+}
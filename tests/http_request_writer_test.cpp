@@ -0,0 +1,114 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2017 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <iostream>
+#include <string>
+
+#define BOOST_TEST_MODULE http_request_writer
+#include <daw/boost_test.h>
+
+#include "http_request_writer.h"
+
+namespace {
+	std::string join( daw::http::http_request_writer const &writer ) {
+		std::array<daw::http::io_segment, daw::http::http_request_writer::max_segments> segs{};
+		auto const count = writer.segments( segs );
+		std::string result{};
+		for( size_t n = 0; n < count; ++n ) {
+			result.append( segs[n].data, segs[n].size );
+		}
+		return result;
+	}
+} // namespace
+
+BOOST_AUTO_TEST_CASE( daw_http_request_writer_test_001 ) {
+	std::string const head = "GET /old/path?x=1 HTTP/1.1\r\n"
+	                         "Host: front.example.com\r\n"
+	                         "X-Internal: secret\r\n"
+	                         "Accept: */*\r\n"
+	                         "\r\n";
+	daw::http::http_request req{};
+	daw::http::http_header_index headers{};
+	BOOST_REQUIRE_EQUAL( daw::http::parse_request_head( head, req, headers ), head.size( ) );
+
+	daw::http::http_request_writer writer{head};
+	writer.set_path( req, "/new" );
+	writer.set_host( req, headers, "back.internal" );
+	writer.remove_header( *headers.find( "X-Internal" ) );
+	writer.add_header( "X-Forwarded-Host", "front.example.com" );
+
+	std::string const expected = "GET /new?x=1 HTTP/1.1\r\n"
+	                             "Host: back.internal\r\n"
+	                             "Accept: */*\r\n"
+	                             "X-Forwarded-Host: front.example.com\r\n"
+	                             "\r\n";
+	BOOST_REQUIRE_EQUAL( join( writer ), expected );
+	BOOST_REQUIRE_EQUAL( writer.size( ), expected.size( ) );
+
+	std::array<daw::http::io_segment, daw::http::http_request_writer::max_segments> segs{};
+	writer.segments( segs );
+	BOOST_REQUIRE( segs[0].data == head.data( ) );
+
+	std::string buffer( expected.size( ), '\0' );
+	BOOST_REQUIRE_EQUAL( writer.write( &buffer[0], buffer.size( ) ), expected.size( ) );
+	BOOST_REQUIRE_EQUAL( buffer, expected );
+	BOOST_REQUIRE_EQUAL( writer.write( &buffer[0], buffer.size( ) - 1 ), 0 );
+}
+
+BOOST_AUTO_TEST_CASE( daw_http_request_writer_test_002 ) {
+	std::string const head = "GET / HTTP/1.1\r\nHost: a\r\n\r\n";
+	daw::http::http_request req{};
+	daw::http::http_header_index headers{};
+	BOOST_REQUIRE_EQUAL( daw::http::parse_request_head( head, req, headers ), head.size( ) );
+
+	daw::http::http_request_writer unchanged{head};
+	BOOST_REQUIRE_EQUAL( join( unchanged ), head );
+
+	daw::http::http_request_writer writer{head};
+	writer.set_path( req, "/a" );
+	BOOST_REQUIRE_THROW( writer.set_path( req, "/b" ), std::exception );
+	BOOST_REQUIRE_THROW( writer.replace( daw::string_view{"elsewhere"}, "x" ), std::exception );
+}
+
+BOOST_AUTO_TEST_CASE( daw_http_request_writer_test_003 ) {
+	auto const rewrite = []( std::string const &head, daw::string_view const path, daw::string_view const query ) {
+		daw::http::http_request req{};
+		daw::http::http_header_index headers{};
+		BOOST_REQUIRE_EQUAL( daw::http::parse_request_head( head, req, headers ), head.size( ) );
+		daw::http::http_request_writer writer{head};
+		if( !path.empty( ) ) {
+			writer.set_path( req, path );
+		}
+		writer.set_query( req, query );
+		return join( writer );
+	};
+	// No query yet, one is added after the path
+	BOOST_REQUIRE_EQUAL( rewrite( "GET /a HTTP/1.1\r\n\r\n", "", "id=7" ), "GET /a?id=7 HTTP/1.1\r\n\r\n" );
+	BOOST_REQUIRE_EQUAL( rewrite( "GET /a HTTP/1.1\r\n\r\n", "/b", "id=7" ), "GET /b?id=7 HTTP/1.1\r\n\r\n" );
+	BOOST_REQUIRE_EQUAL( rewrite( "GET http://a.test HTTP/1.1\r\n\r\n", "", "id=7" ),
+	                     "GET http://a.test?id=7 HTTP/1.1\r\n\r\n" );
+	BOOST_REQUIRE_EQUAL( rewrite( "GET /a#top HTTP/1.1\r\n\r\n", "", "id=7" ), "GET /a?id=7#top HTTP/1.1\r\n\r\n" );
+	BOOST_REQUIRE_EQUAL( rewrite( "GET /a HTTP/1.1\r\n\r\n", "", "" ), "GET /a HTTP/1.1\r\n\r\n" );
+	// An existing query, even an empty one, is replaced
+	BOOST_REQUIRE_EQUAL( rewrite( "GET /a?x=1 HTTP/1.1\r\n\r\n", "", "id=7" ), "GET /a?id=7 HTTP/1.1\r\n\r\n" );
+	BOOST_REQUIRE_EQUAL( rewrite( "GET /a? HTTP/1.1\r\n\r\n", "", "id=7" ), "GET /a?id=7 HTTP/1.1\r\n\r\n" );
+}
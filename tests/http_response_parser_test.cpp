@@ -0,0 +1,70 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2017 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <iostream>
+#include <string>
+
+#define BOOST_TEST_MODULE http_response_decoding
+#include <daw/boost_test.h>
+
+#include "http_response_parser.h"
+
+BOOST_AUTO_TEST_CASE( daw_http_resp_decoding_test_001 ) {
+	std::string const head = "HTTP/1.1 404 Not Found\r\n"
+	                         "Content-Length: 9\r\n"
+	                         "Set-Cookie: a=1\r\n"
+	                         "\r\n"
+	                         "not found";
+	daw::http::http_response resp{};
+	daw::http::http_header_index headers{};
+	BOOST_REQUIRE_EQUAL( daw::http::parse_response_head( head, resp, headers ), head.size( ) - 9 );
+	BOOST_REQUIRE_EQUAL( resp.version.ver_major, 1 );
+	BOOST_REQUIRE_EQUAL( resp.version.ver_minor, 1 );
+	BOOST_REQUIRE_EQUAL( resp.status, 404 );
+	BOOST_REQUIRE_EQUAL( resp.reason, "Not Found" );
+	BOOST_REQUIRE( resp.headers_present.contains( daw::http::known_header::set_cookie ) );
+	BOOST_REQUIRE_EQUAL( headers[daw::http::known_header::content_length], "9" );
+
+	BOOST_REQUIRE_EQUAL( daw::http::parse_response_head( head.substr( 0, 30 ), resp, headers ), 0 );
+}
+
+BOOST_AUTO_TEST_CASE( daw_http_resp_decoding_test_002 ) {
+	auto const no_reason = parse_to_value( "HTTP/1.0 204", daw::http::http_response{} );
+	BOOST_REQUIRE_EQUAL( no_reason.status, 204 );
+	BOOST_REQUIRE_EQUAL( no_reason.version.ver_major, 1 );
+	BOOST_REQUIRE_EQUAL( no_reason.version.ver_minor, 0 );
+	BOOST_REQUIRE_EQUAL( no_reason.reason, "" );
+
+	auto const empty_reason = parse_to_value( "HTTP/2.0 200 ", daw::http::http_response{} );
+	BOOST_REQUIRE_EQUAL( empty_reason.status, 200 );
+	BOOST_REQUIRE_EQUAL( empty_reason.reason, "" );
+	BOOST_REQUIRE_THROW( parse_to_value( "HTTP/1.1 20 OK", daw::http::http_response{} ),
+	                     daw::parser::invalid_input_exception );
+	BOOST_REQUIRE_THROW( parse_to_value( "HTTP/1.1 2000 OK", daw::http::http_response{} ),
+	                     daw::parser::invalid_input_exception );
+	BOOST_REQUIRE_THROW( parse_to_value( "HTTP/1.1 099 OK", daw::http::http_response{} ),
+	                     daw::parser::invalid_input_exception );
+	BOOST_REQUIRE_THROW( parse_to_value( "HTTP/1.1 2x0 OK", daw::http::http_response{} ),
+	                     daw::parser::invalid_input_exception );
+	BOOST_REQUIRE_THROW( parse_to_value( "HTTX/1.1 200 OK", daw::http::http_response{} ),
+	                     daw::parser::invalid_input_exception );
+}
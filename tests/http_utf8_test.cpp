@@ -0,0 +1,121 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2017 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <iostream>
+#include <string>
+
+#define BOOST_TEST_MODULE http_utf8
+#include <daw/boost_test.h>
+
+#include "http_utf8.h"
+
+namespace {
+	constexpr size_t npos = daw::string_view::npos;
+
+	daw::http::percent_decode_result decode( daw::string_view const str, std::string &out ) {
+		out.assign( str.size( ), '\0' );
+		auto const result = daw::http::percent_decode_utf8( str, &out[0] );
+		out.resize( result.size );
+		return result;
+	}
+} // namespace
+
+BOOST_AUTO_TEST_CASE( daw_utf8_validate_test_001 ) {
+	BOOST_REQUIRE_EQUAL( daw::http::utf8_first_invalid( "" ), npos );
+	BOOST_REQUIRE_EQUAL( daw::http::utf8_first_invalid( "/plain/ascii/path/that/is/long" ), npos );
+	BOOST_REQUIRE_EQUAL( daw::http::utf8_first_invalid( "/caf\xC3\xA9/\xE2\x82\xAC/\xF0\x9F\x98\x80" ), npos );
+	BOOST_REQUIRE_EQUAL( daw::http::utf8_first_invalid( "\xED\x9F\xBF\xEE\x80\x80\xF4\x8F\xBF\xBF" ), npos );
+
+	// stray continuation, overlong, surrogate, past U+10FFFF, truncated
+	BOOST_REQUIRE_EQUAL( daw::http::utf8_first_invalid( "/abcdefgh\x80" ), 9 );
+	BOOST_REQUIRE_EQUAL( daw::http::utf8_first_invalid( "/a\xC0\xAF" ), 2 );
+	BOOST_REQUIRE_EQUAL( daw::http::utf8_first_invalid( "/a\xE0\x80\xAF" ), 2 );
+	BOOST_REQUIRE_EQUAL( daw::http::utf8_first_invalid( "ab\xED\xA0\x80" ), 2 );
+	BOOST_REQUIRE_EQUAL( daw::http::utf8_first_invalid( "\xF4\x90\x80\x80" ), 0 );
+	BOOST_REQUIRE_EQUAL( daw::http::utf8_first_invalid( "\xC3\xA9\xE2\x82" ), 2 );
+	BOOST_REQUIRE_EQUAL( daw::http::utf8_first_invalid( "\xC3\xA9\xE2\x82x" ), 2 );
+}
+
+BOOST_AUTO_TEST_CASE( daw_utf8_validate_test_003 ) {
+	// Whole words of multibyte text against the byte at a time validator, every sequence at every offset
+	std::string const pieces[] = {"a",
+	                              "\xC3\xA9",
+	                              "\xDF\xBF",
+	                              "\xE4\xB8\xAD",
+	                              "\xE0\xA0\x80",
+	                              "\xED\x9F\xBF",
+	                              "\xEF\xBF\xBF",
+	                              "\xF0\x90\x80\x80",
+	                              "\xF3\xBF\xBF\xBF",
+	                              "\xF4\x8F\xBF\xBF",
+	                              "\x80",
+	                              "\xC1\xBF",
+	                              "\xC3",
+	                              "\xE4\xB8",
+	                              "\xE0\x9F\xBF",
+	                              "\xED\xA0\x80",
+	                              "\xF0\x8F\xBF\xBF",
+	                              "\xF4\x90\x80\x80",
+	                              "\xF5\x80\x80\x80",
+	                              "\xFF"};
+	for( auto const &first : pieces ) {
+		for( auto const &second : pieces ) {
+			for( size_t pad = 0; pad < 9; ++pad ) {
+				std::string const str = std::string( pad, 'x' ) + "\xE4\xB8\xAD" + first + "\xC3\xA9" + second + "yz";
+				daw::http::utf8_validator bytes{};
+				size_t expected = npos;
+				for( auto const c : str ) {
+					if( !bytes.push( static_cast<uint8_t>( c ) ) ) {
+						expected = bytes.error_offset( );
+						break;
+					}
+				}
+				if( expected == npos && !bytes.complete( ) ) {
+					expected = bytes.error_offset( );
+				}
+				BOOST_REQUIRE_EQUAL( daw::http::utf8_first_invalid( str ), expected );
+			}
+		}
+	}
+	BOOST_REQUIRE_EQUAL( daw::http::utf8_first_invalid( "\xE4\xB8\xAD\xE6\x96\x87\xE5\xAD\x97\xE5\x88\x97" ), npos );
+}
+
+BOOST_AUTO_TEST_CASE( daw_utf8_validate_test_002 ) {
+	std::string out{};
+	auto result = decode( "/caf%C3%A9/%e2%82%ac+x", out );
+	BOOST_REQUIRE_EQUAL( out, "/caf\xC3\xA9/\xE2\x82\xAC+x" );
+	BOOST_REQUIRE_EQUAL( result.invalid_utf8_offset, npos );
+
+	// A sequence split between an escape and a raw byte
+	result = decode( "%C3\xA9", out );
+	BOOST_REQUIRE_EQUAL( out, "\xC3\xA9" );
+	BOOST_REQUIRE_EQUAL( result.invalid_utf8_offset, npos );
+
+	// Offsets are in the decoded output, decoding goes on
+	result = decode( "/ab%2Fc%FF%20d", out );
+	BOOST_REQUIRE_EQUAL( out, "/ab/c\xFF d" );
+	BOOST_REQUIRE_EQUAL( result.invalid_utf8_offset, 5 );
+	result = decode( "/x%E2%82", out );
+	BOOST_REQUIRE_EQUAL( result.invalid_utf8_offset, 2 );
+
+	BOOST_REQUIRE_THROW( decode( "/x%E", out ), daw::parser::invalid_input_exception );
+}
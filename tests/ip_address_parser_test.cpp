@@ -0,0 +1,97 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2017 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <cstdint>
+#include <iostream>
+
+#define BOOST_TEST_MODULE ip_address_parser
+#include <daw/boost_test.h>
+
+#include "ip_address_parser.h"
+
+BOOST_AUTO_TEST_CASE( daw_ipv4_parse_test_001 ) {
+	auto const result = daw::http::parse_ipv4_prefix( "192.168.100.1:80" );
+	BOOST_REQUIRE( result );
+	BOOST_REQUIRE_EQUAL( result.address, 0xC0A8'6401U );
+	BOOST_REQUIRE_EQUAL( result.size, 13 );
+
+	auto const longest = daw::http::parse_ipv4_prefix( "255.255.255.255" );
+	BOOST_REQUIRE( longest );
+	BOOST_REQUIRE_EQUAL( longest.address, 0xFFFF'FFFFU );
+	BOOST_REQUIRE_EQUAL( longest.size, 15 );
+
+	auto const shortest = daw::http::parse_ipv4_prefix( "0.0.0.0" );
+	BOOST_REQUIRE( shortest );
+	BOOST_REQUIRE_EQUAL( shortest.address, 0 );
+}
+
+BOOST_AUTO_TEST_CASE( daw_ipv4_parse_test_002 ) {
+	BOOST_REQUIRE( !daw::http::parse_ipv4_prefix( "256.0.0.1" ) );
+	BOOST_REQUIRE( !daw::http::parse_ipv4_prefix( "01.2.3.4" ) );
+	BOOST_REQUIRE( !daw::http::parse_ipv4_prefix( "1.2.3" ) );
+	BOOST_REQUIRE( !daw::http::parse_ipv4_prefix( "1.2.3.4.5" ) );
+	BOOST_REQUIRE( !daw::http::parse_ipv4_prefix( "1..2.3.4" ) );
+	BOOST_REQUIRE( !daw::http::parse_ipv4_prefix( "1.2.3.1000" ) );
+	BOOST_REQUIRE( !daw::http::parse_ipv4_prefix( "1234.2.3.4" ) );
+	BOOST_REQUIRE( !daw::http::parse_ipv4_prefix( "" ) );
+}
+
+namespace {
+	bool octets_equal( daw::http::ipv6_address const &lhs, std::initializer_list<uint8_t> rhs ) {
+		return std::equal( rhs.begin( ), rhs.end( ), lhs.octets );
+	}
+} // namespace
+
+BOOST_AUTO_TEST_CASE( daw_ipv6_parse_test_001 ) {
+	auto const loopback = daw::http::parse_ipv6( "::1" );
+	BOOST_REQUIRE( loopback );
+	BOOST_REQUIRE( octets_equal( loopback.address, {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1} ) );
+
+	auto const full = daw::http::parse_ipv6( "2001:db8:0:0:1:0:0:FFfe" );
+	BOOST_REQUIRE( full );
+	BOOST_REQUIRE( octets_equal( full.address, {0x20, 0x01, 0x0d, 0xb8, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0xff, 0xfe} ) );
+
+	auto const compressed = daw::http::parse_ipv6( "fe80::1:2" );
+	BOOST_REQUIRE( compressed );
+	BOOST_REQUIRE( octets_equal( compressed.address, {0xfe, 0x80, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 2} ) );
+
+	auto const mapped = daw::http::parse_ipv6( "::ffff:10.0.0.1" );
+	BOOST_REQUIRE( mapped );
+	BOOST_REQUIRE( octets_equal( mapped.address, {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0xff, 0xff, 10, 0, 0, 1} ) );
+
+	BOOST_REQUIRE( daw::http::parse_ipv6( "::" ) );
+	BOOST_REQUIRE( daw::http::parse_ipv6( "1::" ) );
+}
+
+BOOST_AUTO_TEST_CASE( daw_ipv6_parse_test_002 ) {
+	BOOST_REQUIRE( !daw::http::parse_ipv6( "" ) );
+	BOOST_REQUIRE( !daw::http::parse_ipv6( ":1" ) );
+	BOOST_REQUIRE( !daw::http::parse_ipv6( "1:" ) );
+	BOOST_REQUIRE( !daw::http::parse_ipv6( ":::" ) );
+	BOOST_REQUIRE( !daw::http::parse_ipv6( "1::2::3" ) );
+	BOOST_REQUIRE( !daw::http::parse_ipv6( "12345::" ) );
+	BOOST_REQUIRE( !daw::http::parse_ipv6( "1:2:3:4:5:6:7" ) );
+	BOOST_REQUIRE( !daw::http::parse_ipv6( "1:2:3:4:5:6:7:8:9" ) );
+	BOOST_REQUIRE( !daw::http::parse_ipv6( "1:2:3:4:5:6:7::8" ) );
+	BOOST_REQUIRE( !daw::http::parse_ipv6( "::1.2.3" ) );
+	BOOST_REQUIRE( !daw::http::parse_ipv6( "fe80::1%25eth0" ) );
+}
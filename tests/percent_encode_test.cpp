@@ -0,0 +1,64 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2017 Darrell Wright
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files( the "Software" ), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <iostream>
+#include <string>
+
+#define BOOST_TEST_MODULE percent_encode
+#include <daw/boost_test.h>
+
+#include "http_req_parser.h"
+#include "percent_decode_view.h"
+#include "percent_encode.h"
+
+namespace {
+	template<typename CharClass>
+	std::string encode( daw::string_view const str ) {
+		std::string result( daw::percent_encoded_size<CharClass>( str ), '\0' );
+		BOOST_REQUIRE_EQUAL( daw::percent_encode<CharClass>( str, &result[0] ), result.size( ) );
+		return result;
+	}
+
+	using xalpha = daw::http::char_sets::xalpha;
+} // namespace
+
+BOOST_AUTO_TEST_CASE( daw_percent_encode_test_001 ) {
+	BOOST_REQUIRE_EQUAL( encode<xalpha>( "abcdefghIJKLMNOP0123456789" ), "abcdefghIJKLMNOP0123456789" );
+	BOOST_REQUIRE_EQUAL( encode<xalpha>( "a b/c%d" ), "a%20b%2Fc%25d" );
+	BOOST_REQUIRE_EQUAL( encode<xalpha>( "caf\xC3\xA9" ), "caf%C3%A9" );
+	BOOST_REQUIRE_EQUAL( encode<xalpha>( "" ), "" );
+	BOOST_REQUIRE_EQUAL( encode<daw::http::char_sets::digit>( "a1" ), "%611" );
+}
+
+BOOST_AUTO_TEST_CASE( daw_percent_encode_test_002 ) {
+	// What is encoded for a class is accepted by that class and decodes back to the input
+	std::string input{};
+	for( int n = 0; n < 256; ++n ) {
+		input.push_back( static_cast<char>( n ) );
+	}
+	auto const encoded = encode<xalpha>( input );
+	auto const checked = xalpha::check( encoded );
+	BOOST_REQUIRE( checked.found );
+	BOOST_REQUIRE_EQUAL( checked.last, encoded.size( ) );
+	std::string const decoded = daw::make_percent_decode_view( encoded.begin( ), encoded.end( ) );
+	BOOST_REQUIRE( decoded == input );
+}